@@ -18,17 +18,27 @@ QT      += core gui opengl      # Wichtig zum Debuggen
 
 LIBS    += -lOpengl32           # Wichtig zum Debuggen
 
+# physics and game logic, built by Minigolf.pro
+INCLUDEPATH    += $$PWD/golfcore
+DEPENDPATH     += $$PWD/golfcore
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/golfcore/release/ -lgolfcore
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/golfcore/debug/ -lgolfcore
+else:unix: LIBS += -L$$OUT_PWD/golfcore/ -lgolfcore
+
+win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/golfcore/release/libgolfcore.a
+else:win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/golfcore/debug/libgolfcore.a
+else:win32:!win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/golfcore/release/golfcore.lib
+else:win32:!win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/golfcore/debug/golfcore.lib
+else:unix: PRE_TARGETDEPS += $$OUT_PWD/golfcore/libgolfcore.a
+
 SOURCES += main.cpp\
+           glrenderer.cpp \
            mainwindow.cpp \
-           minigolf.cpp \
-           obstacles.cpp \
-           oglwidget.cpp \
-           simulation.cpp
-
-HEADERS += mainwindow.h \
-           minigolf.hpp \
-           obstacles.hpp \
-           oglwidget.h \
-           simulation.hpp
+           oglwidget.cpp
+
+HEADERS += glrenderer.h \
+           mainwindow.h \
+           oglwidget.h
 
 FORMS   += mainwindow.ui
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Builds the physics library, the game app and the tests
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += golfcore \
+           app \
+           tests
+
+app.file    = A08.pro
+app.depends = golfcore
+
+tests.depends = golfcore
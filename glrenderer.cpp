@@ -0,0 +1,560 @@
+#include "glrenderer.h"
+#include "oglwidget.h"
+#include <cstddef>
+#include <algorithm>
+#include <iostream>
+#include <QOpenGLContext>
+
+// Helper function to draw multiple points
+// Usage: glVertexNPoints(v1, v2, v3, ...)
+// using a fold expression
+template <typename... Vec3>
+void glVertexNPoints(const Vec3 &...v)
+{
+    (glVertex3f(v.x, v.y, v.z), ...);
+}
+
+void glNormalVec3(const Vec3 &v)
+{
+    glNormal3f(v.x, v.y, v.z);
+}
+
+template <size_t N>
+void glVertexVecVec3(const std::array<Vec3, N> &v)
+{
+    for (const auto &vec : v)
+    {
+        glVertex3f(vec.x, vec.y, vec.z);
+    }
+}
+
+// course geometry, lit like the fixed function objects:
+// global ambient 0.2 and GL_LIGHT1, a directional light with diffuse 0.1, colors used as material
+// normals are not renormalized, like without GL_NORMALIZE
+static const char *vertexShaderSource = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+uniform mat4 projection;
+uniform mat4 modelView;
+uniform mat3 normalMatrix;
+uniform vec3 lightDirection;
+uniform vec3 color;
+out vec3 shadedColor;
+void main()
+{
+    gl_Position = projection * modelView * vec4(position, 1.0);
+    float diffuse = max(dot(normalMatrix * normal, lightDirection), 0.0);
+    shadedColor = clamp(color * (0.2 + 0.1 * diffuse), 0.0, 1.0);
+}
+)";
+
+// balls, one instance per ball with its own transform and color
+// the normal is the position on the unit sphere, every instance is a rotation scaled by the same factor s in all axes,
+// so the inverse transpose of the matrix is the matrix divided by s * s
+static const char *sphereVertexShaderSource = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in float stripe;
+layout(location = 2) in vec3 ballColor;
+layout(location = 3) in mat4 modelView;
+uniform mat4 projection;
+uniform vec3 lightDirection;
+uniform vec3 stripeColor;
+out vec3 shadedColor;
+void main()
+{
+    gl_Position = projection * modelView * vec4(position, 1.0);
+    mat3 rotation = mat3(modelView);
+    vec3 normal = rotation * position / dot(rotation[0], rotation[0]);
+    vec3 color = mix(ballColor, stripeColor, stripe);
+    float diffuse = max(dot(normal, lightDirection), 0.0);
+    shadedColor = clamp(color * (0.2 + 0.1 * diffuse), 0.0, 1.0);
+}
+)";
+
+static const char *fragmentShaderSource = R"(
+#version 330 core
+in vec3 shadedColor;
+out vec4 fragmentColor;
+void main()
+{
+    fragmentColor = vec4(shadedColor, 1.0);
+}
+)";
+
+void GLRenderer::initialize()
+{
+    meshesSupported = program.addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource) &&
+                      program.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource) &&
+                      program.link() &&
+                      sphereProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, sphereVertexShaderSource) &&
+                      sphereProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource) &&
+                      sphereProgram.link() &&
+                      vertexArray.create() && vertexBuffer.create() && indexBuffer.create();
+    if (!meshesSupported)
+    {
+        std::cout << "Shaders not available, drawing in immediate mode: "
+                  << program.log().toStdString() << sphereProgram.log().toStdString() << std::endl;
+        return;
+    }
+    functions = QOpenGLContext::currentContext()->extraFunctions();
+
+    projectionLocation = program.uniformLocation("projection");
+    modelViewLocation = program.uniformLocation("modelView");
+    normalMatrixLocation = program.uniformLocation("normalMatrix");
+    lightDirectionLocation = program.uniformLocation("lightDirection");
+    colorLocation = program.uniformLocation("color");
+
+    // the layout of MeshBuilder::Vertex, the index buffer stays bound to the vertex array
+    vertexArray.bind();
+    vertexBuffer.bind();
+    program.enableAttributeArray(0);
+    program.setAttributeBuffer(0, GL_FLOAT, offsetof(MeshBuilder::Vertex, position), 3, sizeof(MeshBuilder::Vertex));
+    program.enableAttributeArray(1);
+    program.setAttributeBuffer(1, GL_FLOAT, offsetof(MeshBuilder::Vertex, normal), 3, sizeof(MeshBuilder::Vertex));
+    indexBuffer.bind();
+    vertexArray.release();
+    vertexBuffer.release();
+}
+
+void GLRenderer::releaseGL()
+{
+    indexBuffer.destroy();
+    vertexBuffer.destroy();
+    vertexArray.destroy();
+    program.removeAllShaders();
+    for (auto &entry : sphereBatches)
+    {
+        SphereBatch &batch = *entry.second;
+        batch.instanceBuffer.destroy();
+        batch.indexBuffer.destroy();
+        batch.vertexBuffer.destroy();
+        batch.vertexArray.destroy();
+    }
+    sphereBatches.clear();
+    sphereProgram.removeAllShaders();
+    meshesSupported = false;
+    staticKey = 0;
+    builder.clear();
+}
+
+void GLRenderer::setCamera(const QMatrix4x4 &projection, const QMatrix4x4 &modelView, const QVector3D &lightDirection)
+{
+    this->projection = projection;
+    this->modelView = modelView;
+    this->lightDirection = lightDirection;
+    modelViews.clear();
+}
+
+void GLRenderer::pushTransform(const Vec3 &translation)
+{
+    glPushMatrix();
+    glTranslatef(translation.x, translation.y, translation.z);
+    modelViews.push_back(modelView);
+    modelView.translate(translation.x, translation.y, translation.z);
+}
+
+void GLRenderer::popTransform()
+{
+    glPopMatrix();
+    modelView = modelViews.back();
+    modelViews.pop_back();
+}
+
+void GLRenderer::uploadStatic(const std::function<void(Renderer &)> &drawGeometry)
+{
+    builder.clear();
+    drawGeometry(builder);
+    builder.finish();
+
+    auto &vertices = builder.getVertices();
+    auto &indices = builder.getIndices();
+    vertexArray.bind();
+    vertexBuffer.bind();
+    vertexBuffer.allocate(vertices.data(), static_cast<int>(vertices.size() * sizeof(MeshBuilder::Vertex)));
+    indexBuffer.bind();
+    indexBuffer.allocate(indices.data(), static_cast<int>(indices.size() * sizeof(unsigned int)));
+    vertexArray.release();
+    vertexBuffer.release();
+}
+
+void GLRenderer::drawStatic(unsigned long long key, const std::function<void(Renderer &)> &drawGeometry)
+{
+    if (!meshesSupported)
+    {
+        drawGeometry(*this);
+        return;
+    }
+
+    // only a new course is uploaded, the buffers stay on the gpu between frames
+    if (key != staticKey)
+    {
+        uploadStatic(drawGeometry);
+        staticKey = key;
+    }
+
+    program.bind();
+    program.setUniformValue(projectionLocation, projection);
+    program.setUniformValue(modelViewLocation, modelView);
+    program.setUniformValue(normalMatrixLocation, modelView.normalMatrix());
+    program.setUniformValue(lightDirectionLocation, lightDirection);
+    vertexArray.bind();
+    for (const MeshBuilder::Batch &batch : builder.getBatches())
+    {
+        program.setUniformValue(colorLocation, QVector3D(batch.color.x, batch.color.y, batch.color.z));
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(batch.indexCount), GL_UNSIGNED_INT,
+                       reinterpret_cast<const void *>(batch.firstIndex * sizeof(unsigned int)));
+    }
+    vertexArray.release();
+    program.release();
+
+    // spheres keep their stripes and rotation, they are drawn like the moving ones
+    for (const MeshBuilder::PlacedSphere &placed : builder.getSpheres())
+    {
+        pushTransform(placed.offset);
+        drawSphere(*placed.sphere);
+        popTransform();
+    }
+}
+
+void GLRenderer::drawTriangle(Triangle &triangle)
+{
+    auto &position = triangle.getPosition();
+    auto &color = triangle.getColor();
+    auto corners = triangle.getCorners();
+
+    glPushMatrix();
+    glBegin(GL_TRIANGLES);
+    glTranslatef(position.x, position.y, position.z);
+    glColor3f(color.x, color.y, color.z);
+    glNormalVec3(triangle.getNormal());
+    glVertexVecVec3(corners);
+    glEnd();
+    glPopMatrix();
+}
+
+void GLRenderer::drawWall(Wall &wall)
+{
+    auto &position = wall.getPosition();
+    auto &color = wall.getColor();
+
+    // draw wall
+    glPushMatrix();
+    glTranslated(position.x, position.y, position.z);
+    // wall defined by 4 corners
+    glColor3f(color.x, color.y, color.z);
+    glBegin(GL_QUADS);
+    glNormalVec3(wall.getNormal());
+
+    // dont need worldCorners, because relative position is already applied in parent matrix
+    glVertexVecVec3(wall.getCorners());
+
+    glEnd();
+    glPopMatrix();
+}
+
+void GLRenderer::drawPolygon(ConvexPolygon &polygon)
+{
+    auto &position = polygon.getPosition();
+    auto &color = polygon.getColor();
+
+    glPushMatrix();
+    glTranslated(position.x, position.y, position.z);
+    glColor3f(color.x, color.y, color.z);
+    // convex, so a fan around the first corner covers it
+    glBegin(GL_TRIANGLE_FAN);
+    glNormalVec3(polygon.getNormal());
+    for (const auto &corner : polygon.getCorners())
+    {
+        glVertex3f(corner.x, corner.y, corner.z);
+    }
+    glEnd();
+    glPopMatrix();
+}
+
+// velocity, floor normal and rotation axis of a sphere, drawn from the current origin
+void GLRenderer::drawSphereAxes(Sphere &sphere)
+{
+    if (!OGLWidget::showAxis)
+        return;
+
+    auto &velocity = sphere.getVelocity();
+    auto &currentFloorNormal = sphere.getFloorNormal();
+    double radius = sphere.getRadius();
+
+    // draw movement vector
+    auto embiggenedVelocity = velocity.normalized() * radius * 2;
+    glBegin(GL_LINES);
+    glColor3f(1, 0, 0);
+    glVertexNPoints(Vec3(0, 0, 0), embiggenedVelocity);
+    glEnd();
+
+    // draw floor normal
+    auto embiggenedFloorNormal = currentFloorNormal.normalized() * radius * 2;
+    glBegin(GL_LINES);
+    glColor3f(0, 1, 0);
+    glVertexNPoints(Vec3(0, 0, 0), embiggenedFloorNormal);
+    glEnd();
+
+    // draw rotation axis
+    auto embiggenedRotationAxis = currentFloorNormal.cross(velocity).normalized() * radius * 2;
+    glBegin(GL_LINES);
+    glColor3f(0, 0, 1);
+    glVertexNPoints(Vec3(0, 0, 0), embiggenedRotationAxis);
+    glEnd();
+}
+
+void GLRenderer::drawSphere(Sphere &sphere)
+{
+    if (!meshesSupported)
+    {
+        drawSphereImmediate(sphere);
+        return;
+    }
+
+    auto &position = sphere.getPosition();
+    auto &color = sphere.getColor();
+    double radius = sphere.getRadius();
+
+    if (OGLWidget::showAxis)
+    {
+        glPushMatrix();
+        glTranslatef(position.x, position.y, position.z);
+        drawSphereAxes(sphere);
+        glPopMatrix();
+    }
+
+    // drawn with the other spheres of its resolution in flushSpheres
+    float rotation[16];
+    sphere.getOrientation().toMatrix(rotation);
+    QMatrix4x4 sphereModelView = modelView;
+    sphereModelView.translate(position.x, position.y, position.z);
+    // QMatrix4x4 takes the values row by row, toMatrix writes them column by column like OpenGL
+    sphereModelView *= QMatrix4x4(rotation).transposed();
+    sphereModelView.scale(radius);
+
+    SphereInstance instance;
+    std::copy(sphereModelView.constData(), sphereModelView.constData() + 16, instance.modelView);
+    instance.color[0] = color.x;
+    instance.color[1] = color.y;
+    instance.color[2] = color.z;
+    getSphereBatch(sphere.getResolution()).instances.push_back(instance);
+}
+
+GLRenderer::SphereBatch &GLRenderer::getSphereBatch(int resolution)
+{
+    std::unique_ptr<SphereBatch> &entry = sphereBatches[resolution];
+    if (entry != nullptr)
+        return *entry;
+
+    // the unit sphere of each resolution is built and uploaded once
+    entry = std::make_unique<SphereBatch>();
+    SphereBatch &batch = *entry;
+    std::vector<MeshBuilder::SphereVertex> vertices;
+    std::vector<unsigned int> indices;
+    MeshBuilder::buildSphere(resolution, vertices, indices);
+    batch.indexCount = static_cast<int>(indices.size());
+
+    batch.vertexArray.create();
+    batch.vertexBuffer.create();
+    batch.indexBuffer.create();
+    batch.instanceBuffer.create();
+    batch.instanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+
+    batch.vertexArray.bind();
+    batch.vertexBuffer.bind();
+    batch.vertexBuffer.allocate(vertices.data(), static_cast<int>(vertices.size() * sizeof(MeshBuilder::SphereVertex)));
+    sphereProgram.enableAttributeArray(0);
+    sphereProgram.setAttributeBuffer(0, GL_FLOAT, offsetof(MeshBuilder::SphereVertex, position), 3, sizeof(MeshBuilder::SphereVertex));
+    sphereProgram.enableAttributeArray(1);
+    sphereProgram.setAttributeBuffer(1, GL_FLOAT, offsetof(MeshBuilder::SphereVertex, stripe), 1, sizeof(MeshBuilder::SphereVertex));
+
+    // color and the four columns of the matrix advance once per ball
+    batch.instanceBuffer.bind();
+    sphereProgram.enableAttributeArray(2);
+    sphereProgram.setAttributeBuffer(2, GL_FLOAT, offsetof(SphereInstance, color), 3, sizeof(SphereInstance));
+    functions->glVertexAttribDivisor(2, 1);
+    for (int column = 0; column < 4; column++)
+    {
+        sphereProgram.enableAttributeArray(3 + column);
+        sphereProgram.setAttributeBuffer(3 + column, GL_FLOAT, offsetof(SphereInstance, modelView) + column * 4 * sizeof(float), 4, sizeof(SphereInstance));
+        functions->glVertexAttribDivisor(3 + column, 1);
+    }
+
+    batch.indexBuffer.bind();
+    batch.indexBuffer.allocate(indices.data(), static_cast<int>(indices.size() * sizeof(unsigned int)));
+    batch.vertexArray.release();
+    batch.instanceBuffer.release();
+    return batch;
+}
+
+void GLRenderer::flushSpheres()
+{
+    if (!meshesSupported)
+        return;
+
+    sphereProgram.bind();
+    sphereProgram.setUniformValue("projection", projection);
+    sphereProgram.setUniformValue("lightDirection", lightDirection);
+    sphereProgram.setUniformValue("stripeColor", QVector3D(1, 0.7, 1));
+    for (auto &entry : sphereBatches)
+    {
+        SphereBatch &batch = *entry.second;
+        if (batch.instances.empty())
+            continue;
+
+        // one draw call for all balls of this resolution
+        batch.vertexArray.bind();
+        batch.instanceBuffer.bind();
+        batch.instanceBuffer.allocate(batch.instances.data(), static_cast<int>(batch.instances.size() * sizeof(SphereInstance)));
+        functions->glDrawElementsInstanced(GL_TRIANGLES, batch.indexCount, GL_UNSIGNED_INT, nullptr,
+                                           static_cast<GLsizei>(batch.instances.size()));
+        batch.vertexArray.release();
+        batch.instanceBuffer.release();
+        batch.instances.clear();
+    }
+    sphereProgram.release();
+}
+
+// the same sphere, built vertex by vertex, used without shaders
+void GLRenderer::drawSphereImmediate(Sphere &sphere)
+{
+    auto &position = sphere.getPosition();
+    auto &color = sphere.getColor();
+    double radius = sphere.getRadius();
+    int resolution = sphere.getResolution();
+
+    glPushMatrix();
+
+    // position
+    glTranslatef(position.x, position.y, position.z);
+
+    drawSphereAxes(sphere);
+
+    // rotation, the matrix is only built here
+    float rotation[16];
+    sphere.getOrientation().toMatrix(rotation);
+    glMultMatrixf(rotation);
+    // scale with radius
+    glScalef(radius, radius, radius);
+
+    // color
+    glColor3f(color.x, color.y, color.z);
+
+    for (float beta = 0.0; beta <= PI - 0.0001; beta += PI / resolution)
+    {
+        int step = round(beta * resolution / PI + 0.0001);
+        switch (step % 2)
+        {
+        case 0:
+            glColor3f(color.x, color.y, color.z);
+            break;
+        case 1:
+            glColor3f(1, 0.7, 1);
+            break;
+        }
+
+        glBegin(GL_TRIANGLE_STRIP);
+        for (float alpha = 0.0; alpha < 2.01 * PI; alpha += PI / resolution)
+        {
+            float x = sin(beta) * cos(alpha);
+            float y = sin(beta) * sin(alpha);
+            float z = cos(beta);
+
+            glNormalVec3(Vec3(x, y, z));
+            glVertex3f(x, y, z);
+            x = sin(beta + PI / resolution) * cos(alpha);
+            y = sin(beta + PI / resolution) * sin(alpha);
+            z = cos(beta + PI / resolution);
+
+            glNormalVec3(Vec3(x, y, z));
+            glVertex3f(x, y, z);
+        }
+        glEnd();
+    }
+
+    glPopMatrix();
+}
+
+void GLRenderer::drawBox(Box &box)
+{
+    auto &position = box.getPosition();
+    auto &walls = box.getWalls();
+    size_t outerWallCount = box.getOuterWallCount();
+
+    glPushMatrix();
+    glTranslatef(position.x, position.y, position.z);
+
+    // draw floor
+
+    glBegin(GL_TRIANGLE_FAN);
+    glNormalVec3(Vec3(0, 1, 0));
+    glColor3f(0.5, 0.5, 0.5);
+    glVertex3f(0, 0, 0);
+    for (size_t i = 0; i <= outerWallCount; i++)
+    {
+        const auto &corner = walls[i % outerWallCount].getCorners()[0];
+        glVertexNPoints(corner);
+    }
+    glEnd();
+
+    // draw walls
+    for (Wall &wall : walls)
+    {
+        wall.draw(*this);
+    }
+
+    glPopMatrix();
+}
+
+void GLRenderer::drawHeightfield(Heightfield &heightfield)
+{
+    auto &position = heightfield.getPosition();
+    auto &color = heightfield.getColor();
+    auto &indices = heightfield.getStripIndices();
+
+    glPushMatrix();
+    glTranslatef(position.x, position.y, position.z);
+    glColor3f(color.x, color.y, color.z);
+
+    // the whole grid in one call from the arrays of the heightfield
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, heightfield.getVertices().data());
+    glNormalPointer(GL_FLOAT, 0, heightfield.getNormals().data());
+    glDrawElements(GL_TRIANGLE_STRIP, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, indices.data());
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glPopMatrix();
+}
+
+void GLRenderer::drawHole(const Vec3 &position)
+{
+    // TODO: draw flag
+    glColor3f(0.3, 0.3, 0.3);
+    glPushMatrix();
+    glTranslatef(position.x, position.y, position.z);
+    glLineWidth(5);
+    glBegin(GL_LINES);
+    glVertex3f(0, 0, 0);
+    glVertex3f(0, 4, 0);
+    glEnd();
+    glBegin(GL_TRIANGLES);
+    glColor3f(0.9, 1, 0.9);
+    glVertex3f(0, 4, 0);
+    glVertex3f(0.7, 3.5, 0);
+    glVertex3f(0, 3, 0);
+    glEnd();
+    glPopMatrix();
+}
+
+void GLRenderer::drawLine(const Vec3 &from, const Vec3 &to, const Vec3 &color, float width)
+{
+    glColor3f(color.x, color.y, color.z);
+    glLineWidth(width);
+    glBegin(GL_LINES);
+    glVertexNPoints(from, to);
+    glEnd();
+}
@@ -0,0 +1,102 @@
+#ifndef GLRENDERER_H
+#define GLRENDERER_H
+
+#include "simulation.hpp"
+#include "meshbuilder.hpp"
+
+#include <QOpenGLShaderProgram>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLVertexArrayObject>
+#include <QOpenGLBuffer>
+#include <QMatrix4x4>
+#include <map>
+#include <memory>
+
+// Draws simulation objects with OpenGL
+// static course geometry is uploaded once into buffers and drawn with a shader, one draw call per color
+// spheres are collected and drawn instanced, one draw call per resolution
+// everything else is drawn in immediate mode
+// requires a current GL context, used from OGLWidget::paintGL
+class GLRenderer : public Renderer
+{
+    // course geometry, see drawStatic
+    QOpenGLShaderProgram program;
+    QOpenGLVertexArrayObject vertexArray;
+    QOpenGLBuffer vertexBuffer{QOpenGLBuffer::VertexBuffer};
+    QOpenGLBuffer indexBuffer{QOpenGLBuffer::IndexBuffer};
+    // false if the shader could not be built, then the course is drawn in immediate mode too
+    bool meshesSupported = false;
+    // key of the geometry in the buffers, 0 if there is none
+    unsigned long long staticKey = 0;
+    // kept between uploads so rebuilding does not allocate
+    MeshBuilder builder;
+    int projectionLocation = -1;
+    int modelViewLocation = -1;
+    int normalMatrixLocation = -1;
+    int lightDirectionLocation = -1;
+    int colorLocation = -1;
+
+    // per ball data of the sphere shader, the layout of its instance attributes
+    struct SphereInstance
+    {
+        float modelView[16];
+        float color[3];
+    };
+
+    // unit sphere of one resolution and the balls drawn with it since the last flushSpheres
+    struct SphereBatch
+    {
+        QOpenGLVertexArrayObject vertexArray;
+        QOpenGLBuffer vertexBuffer{QOpenGLBuffer::VertexBuffer};
+        QOpenGLBuffer indexBuffer{QOpenGLBuffer::IndexBuffer};
+        QOpenGLBuffer instanceBuffer{QOpenGLBuffer::VertexBuffer};
+        int indexCount = 0;
+        std::vector<SphereInstance> instances;
+    };
+
+    QOpenGLShaderProgram sphereProgram;
+    // built on first use, kept until releaseGL
+    std::map<int, std::unique_ptr<SphereBatch>> sphereBatches;
+    // instanced drawing, not part of the OpenGL 1 functions the rest uses
+    QOpenGLExtraFunctions *functions = nullptr;
+
+    // same transforms as the GL matrix stack, for the shader
+    QMatrix4x4 projection;
+    QMatrix4x4 modelView;
+    std::vector<QMatrix4x4> modelViews;
+    QVector3D lightDirection;
+
+    // records the geometry into builder and copies it into the buffers
+    void uploadStatic(const std::function<void(Renderer&)>& drawGeometry);
+    SphereBatch& getSphereBatch(int resolution);
+    void drawSphereAxes(Sphere& sphere);
+    void drawSphereImmediate(Sphere& sphere);
+
+public:
+    // call once with the context current, before anything is drawn
+    void initialize();
+    // frees the buffers and the shader, call with the context current before it is destroyed
+    void releaseGL();
+    // matrices the frame is drawn with, and the direction towards the light in eye space
+    // must match the GL matrices and GL_LIGHT1, so shaded and immediate mode objects look the same
+    void setCamera(const QMatrix4x4& projection, const QMatrix4x4& modelView, const QVector3D& lightDirection);
+
+    void pushTransform(const Vec3& translation);
+    void popTransform();
+
+    void drawTriangle(Triangle& triangle);
+    void drawWall(Wall& wall);
+    void drawPolygon(ConvexPolygon& polygon);
+    void drawSphere(Sphere& sphere);
+    void drawBox(Box& box);
+    void drawHeightfield(Heightfield& heightfield);
+
+    void drawHole(const Vec3& position);
+    void drawLine(const Vec3& from, const Vec3& to, const Vec3& color, float width);
+
+    void drawStatic(unsigned long long key, const std::function<void(Renderer&)>& drawGeometry);
+    // draws the spheres collected since the last call, call once per frame after drawing
+    void flushSpheres();
+};
+
+#endif // GLRENDERER_H
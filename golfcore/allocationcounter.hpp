@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+// Counts calls of the global operator new of the whole program, including the array, nothrow and aligned forms
+// Only built with CONFIG+=count_allocations (defines GOLF_COUNT_ALLOCATIONS), which replaces operator new and delete.
+// minigolf.cpp references the counter, so the replacement is linked from the static library into every program using Game.
+// Used to check that Game::update does not allocate once the game is running:
+// take the count before and after some updates, the difference should be 0.
+
+// false if the counter is not built in, getAllocationCount is always 0 then
+bool isCountingAllocations();
+unsigned long long getAllocationCount();
+
+#endif // ALLOCATIONCOUNTER_HPP
@@ -0,0 +1,35 @@
+#include "arena.hpp"
+#include <algorithm>
+
+Arena::~Arena()
+{
+    for (auto it = destructors.rbegin(); it != destructors.rend(); ++it)
+        it->destroy(it->object);
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+    if (!blocks.empty())
+    {
+        size_t start = (used + alignment - 1) & ~(alignment - 1);
+        if (start + size <= blocks.back().size)
+        {
+            used = start + size;
+            return blocks.back().data.get() + start;
+        }
+    }
+
+    // new block, objects larger than a block get one of their own
+    size_t newSize = std::max(blockSize, size);
+    blocks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[newSize]), newSize});
+    used = size;
+    return blocks.back().data.get();
+}
+
+size_t Arena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const Block &block : blocks)
+        capacity += block.size;
+    return capacity;
+}
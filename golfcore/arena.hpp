@@ -0,0 +1,59 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+// Allocates objects one after another in large blocks and frees them all at once
+// A course creates its geometry here, so the objects of a course lie close together in memory
+// and loading or dropping a course is a few block allocations instead of one per object.
+// Objects live until the arena is destroyed, their destructors then run in reverse order of creation.
+class Arena
+{
+private:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void *);
+        void *object;
+    };
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    // bytes used in the last block
+    size_t used = 0;
+    std::vector<Destructor> destructors;
+
+    void *allocate(size_t size, size_t alignment);
+
+public:
+    explicit Arena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+    ~Arena();
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // constructs a T in the arena, the arena owns it
+    template <typename T, typename... Args>
+    T *create(Args &&...args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over aligned types are not supported");
+        T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value)
+            destructors.push_back({[](void *p) { static_cast<T *>(p)->~T(); }, object});
+        return object;
+    }
+
+    // bytes in all blocks
+    size_t getCapacity() const;
+};
+
+#endif // ARENA_HPP
@@ -0,0 +1,423 @@
+#include "collisionstore.hpp"
+#include <cmath>
+
+// GOLF_NO_SIMD forces the scalar kernel, the tests use it to compare the kernels
+#if defined(GOLF_NO_SIMD)
+#elif defined(__AVX2__)
+#define GOLF_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GOLF_SSE2
+#include <emmintrin.h>
+#endif
+
+// true if the slots s[0] ... s[n-1] follow each other, then their values can be loaded directly
+// the slots need not be sorted, so every slot is compared, not just the last one
+static inline bool areConsecutive(const size_t *s, size_t n)
+{
+    for (size_t k = 1; k < n; k++)
+    {
+        if (s[k] != s[0] + k)
+            return false;
+    }
+    return true;
+}
+
+template <typename T>
+void BasicTriangleStore<T>::clear()
+{
+    for (auto *v : {&ax, &ay, &az, &nx, &ny, &nz, &v0x, &v0y, &v0z, &v1x, &v1y, &v1z, &dot00, &dot01, &dot11, &invDenom})
+        v->clear();
+    faceOnly.clear();
+    triangles.clear();
+}
+
+// appends the coordinates of v, already rounded to the scalar type of the store by the Vec3T conversion
+template <typename T>
+static void pushVec3(std::vector<T> &x, std::vector<T> &y, std::vector<T> &z, const Vec3T<T> &v)
+{
+    x.push_back(v.x);
+    y.push_back(v.y);
+    z.push_back(v.z);
+}
+
+template <typename T>
+size_t BasicTriangleStore<T>::add(Triangle &triangle)
+{
+    const BakedTriangle &b = triangle.getBaked();
+    pushVec3(ax, ay, az, Vec3T<T>(b.corners[0]));
+    pushVec3(nx, ny, nz, Vec3T<T>(b.normal));
+    pushVec3(v0x, v0y, v0z, Vec3T<T>(b.v0));
+    pushVec3(v1x, v1y, v1z, Vec3T<T>(b.v1));
+    dot00.push_back(b.dot00);
+    dot01.push_back(b.dot01);
+    dot11.push_back(b.dot11);
+    invDenom.push_back(b.invDenom);
+    faceOnly.push_back(triangle.isFaceCollisionOnly());
+    triangles.push_back(&triangle);
+    return triangles.size() - 1;
+}
+
+// same steps as Triangle::findContacts up to its first added contact
+// for double the limits are radius, -0.0 and 1.0 like in Triangle::findContacts
+template <typename T>
+size_t BasicTriangleStore<T>::testScalar(const Vec3 &center, double radius, const size_t *slots, size_t first, size_t count) const
+{
+    const T cx = static_cast<T>(center.x);
+    const T cy = static_cast<T>(center.y);
+    const T cz = static_cast<T>(center.z);
+    const T r = static_cast<T>(radius) + tolerance;
+    const T zero = -tolerance;
+    const T one = T(1) + tolerance;
+    for (size_t i = first; i < count; i++)
+    {
+        size_t s = slots[i];
+        T dx = cx - ax[s];
+        T dy = cy - ay[s];
+        T dz = cz - az[s];
+        T newDist = nx[s] * dx + ny[s] * dy + nz[s] * dz;
+        T dist = std::fabs(newDist);
+        if (dist > r)
+            continue;
+        // corners and edges are checked in Triangle::findContacts
+        if (!faceOnly[s])
+            return i;
+
+        T v2x = (cx - nx[s] * newDist) - ax[s];
+        T v2y = (cy - ny[s] * newDist) - ay[s];
+        T v2z = (cz - nz[s] * newDist) - az[s];
+        T dot02 = v0x[s] * v2x + v0y[s] * v2y + v0z[s] * v2z;
+        T dot12 = v1x[s] * v2x + v1y[s] * v2y + v1z[s] * v2z;
+        T u = (dot11[s] * dot02 - dot01[s] * dot12) * invDenom[s];
+        T v = (dot00[s] * dot12 - dot01[s] * dot02) * invDenom[s];
+        if ((u >= zero) && (v >= zero) && (u + v <= one))
+            return i;
+    }
+    return count;
+}
+
+#if defined(GOLF_AVX2)
+
+// loads 4 values, directly if the slots are consecutive
+static inline __m256d load4(const std::vector<double> &a, const size_t *s, bool consecutive)
+{
+    if (consecutive)
+        return _mm256_loadu_pd(&a[s[0]]);
+    return _mm256_set_pd(a[s[3]], a[s[2]], a[s[1]], a[s[0]]);
+}
+
+template <>
+size_t TriangleStore::findFirstHit(const Vec3 &center, double radius, const size_t *slots, size_t count) const
+{
+    const __m256d cx = _mm256_set1_pd(center.x);
+    const __m256d cy = _mm256_set1_pd(center.y);
+    const __m256d cz = _mm256_set1_pd(center.z);
+    const __m256d r = _mm256_set1_pd(radius);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d zero = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const size_t *s = slots + i;
+        bool consecutive = areConsecutive(s, 4);
+
+        __m256d pax = load4(ax, s, consecutive);
+        __m256d pay = load4(ay, s, consecutive);
+        __m256d paz = load4(az, s, consecutive);
+        __m256d pnx = load4(nx, s, consecutive);
+        __m256d pny = load4(ny, s, consecutive);
+        __m256d pnz = load4(nz, s, consecutive);
+
+        // distance to the plane
+        __m256d dx = _mm256_sub_pd(cx, pax);
+        __m256d dy = _mm256_sub_pd(cy, pay);
+        __m256d dz = _mm256_sub_pd(cz, paz);
+        __m256d newDist = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(pnx, dx), _mm256_mul_pd(pny, dy)), _mm256_mul_pd(pnz, dz));
+        __m256d dist = _mm256_andnot_pd(signMask, newDist);
+        // not (dist > radius), true for nan like the scalar check
+        int planeBits = _mm256_movemask_pd(_mm256_cmp_pd(dist, r, _CMP_NGT_UQ));
+        if (planeBits == 0)
+            continue;
+
+        int faceBits = faceOnly[s[0]] | (faceOnly[s[1]] << 1) | (faceOnly[s[2]] << 2) | (faceOnly[s[3]] << 3);
+
+        // barycentric coordinates of the closest point on the plane
+        __m256d v2x = _mm256_sub_pd(_mm256_sub_pd(cx, _mm256_mul_pd(pnx, newDist)), pax);
+        __m256d v2y = _mm256_sub_pd(_mm256_sub_pd(cy, _mm256_mul_pd(pny, newDist)), pay);
+        __m256d v2z = _mm256_sub_pd(_mm256_sub_pd(cz, _mm256_mul_pd(pnz, newDist)), paz);
+        __m256d dot02 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(load4(v0x, s, consecutive), v2x), _mm256_mul_pd(load4(v0y, s, consecutive), v2y)), _mm256_mul_pd(load4(v0z, s, consecutive), v2z));
+        __m256d dot12 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(load4(v1x, s, consecutive), v2x), _mm256_mul_pd(load4(v1y, s, consecutive), v2y)), _mm256_mul_pd(load4(v1z, s, consecutive), v2z));
+        __m256d d00 = load4(dot00, s, consecutive);
+        __m256d d01 = load4(dot01, s, consecutive);
+        __m256d d11 = load4(dot11, s, consecutive);
+        __m256d inv = load4(invDenom, s, consecutive);
+        __m256d u = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(d11, dot02), _mm256_mul_pd(d01, dot12)), inv);
+        __m256d v = _mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(d00, dot12), _mm256_mul_pd(d01, dot02)), inv);
+        __m256d inside = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(u, zero, _CMP_GE_OQ), _mm256_cmp_pd(v, zero, _CMP_GE_OQ)),
+                                       _mm256_cmp_pd(_mm256_add_pd(u, v), one, _CMP_LE_OQ));
+        int insideBits = _mm256_movemask_pd(inside);
+
+        int hitBits = planeBits & (~faceBits | insideBits) & 0xF;
+        for (int k = 0; k < 4; k++)
+        {
+            if (hitBits & (1 << k))
+                return i + k;
+        }
+    }
+
+    return testScalar(center, radius, slots, i, count);
+}
+
+// loads 8 values, directly if the slots are consecutive
+static inline __m256 load8(const std::vector<float> &a, const size_t *s, bool consecutive)
+{
+    if (consecutive)
+        return _mm256_loadu_ps(&a[s[0]]);
+    return _mm256_set_ps(a[s[7]], a[s[6]], a[s[5]], a[s[4]], a[s[3]], a[s[2]], a[s[1]], a[s[0]]);
+}
+
+template <>
+size_t FloatTriangleStore::findFirstHit(const Vec3 &center, double radius, const size_t *slots, size_t count) const
+{
+    const __m256 cx = _mm256_set1_ps(static_cast<float>(center.x));
+    const __m256 cy = _mm256_set1_ps(static_cast<float>(center.y));
+    const __m256 cz = _mm256_set1_ps(static_cast<float>(center.z));
+    const __m256 r = _mm256_set1_ps(static_cast<float>(radius) + tolerance);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_set1_ps(-tolerance);
+    const __m256 one = _mm256_set1_ps(1.0f + tolerance);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const size_t *s = slots + i;
+        bool consecutive = areConsecutive(s, 8);
+
+        __m256 pax = load8(ax, s, consecutive);
+        __m256 pay = load8(ay, s, consecutive);
+        __m256 paz = load8(az, s, consecutive);
+        __m256 pnx = load8(nx, s, consecutive);
+        __m256 pny = load8(ny, s, consecutive);
+        __m256 pnz = load8(nz, s, consecutive);
+
+        // distance to the plane
+        __m256 dx = _mm256_sub_ps(cx, pax);
+        __m256 dy = _mm256_sub_ps(cy, pay);
+        __m256 dz = _mm256_sub_ps(cz, paz);
+        __m256 newDist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pnx, dx), _mm256_mul_ps(pny, dy)), _mm256_mul_ps(pnz, dz));
+        __m256 dist = _mm256_andnot_ps(signMask, newDist);
+        int planeBits = _mm256_movemask_ps(_mm256_cmp_ps(dist, r, _CMP_NGT_UQ));
+        if (planeBits == 0)
+            continue;
+
+        int faceBits = 0;
+        for (int k = 0; k < 8; k++)
+            faceBits |= faceOnly[s[k]] << k;
+
+        // barycentric coordinates of the closest point on the plane
+        __m256 v2x = _mm256_sub_ps(_mm256_sub_ps(cx, _mm256_mul_ps(pnx, newDist)), pax);
+        __m256 v2y = _mm256_sub_ps(_mm256_sub_ps(cy, _mm256_mul_ps(pny, newDist)), pay);
+        __m256 v2z = _mm256_sub_ps(_mm256_sub_ps(cz, _mm256_mul_ps(pnz, newDist)), paz);
+        __m256 dot02 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(load8(v0x, s, consecutive), v2x), _mm256_mul_ps(load8(v0y, s, consecutive), v2y)), _mm256_mul_ps(load8(v0z, s, consecutive), v2z));
+        __m256 dot12 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(load8(v1x, s, consecutive), v2x), _mm256_mul_ps(load8(v1y, s, consecutive), v2y)), _mm256_mul_ps(load8(v1z, s, consecutive), v2z));
+        __m256 d00 = load8(dot00, s, consecutive);
+        __m256 d01 = load8(dot01, s, consecutive);
+        __m256 d11 = load8(dot11, s, consecutive);
+        __m256 inv = load8(invDenom, s, consecutive);
+        __m256 u = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(d11, dot02), _mm256_mul_ps(d01, dot12)), inv);
+        __m256 v = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(d00, dot12), _mm256_mul_ps(d01, dot02)), inv);
+        __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(v, zero, _CMP_GE_OQ)),
+                                      _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+        int insideBits = _mm256_movemask_ps(inside);
+
+        int hitBits = planeBits & (~faceBits | insideBits) & 0xFF;
+        for (int k = 0; k < 8; k++)
+        {
+            if (hitBits & (1 << k))
+                return i + k;
+        }
+    }
+
+    return testScalar(center, radius, slots, i, count);
+}
+
+template <typename T>
+const char *BasicTriangleStore<T>::getKernelName()
+{
+    return "avx2";
+}
+
+#elif defined(GOLF_SSE2)
+
+// loads 2 values, directly if the slots are consecutive
+static inline __m128d load2(const std::vector<double> &a, const size_t *s, bool consecutive)
+{
+    if (consecutive)
+        return _mm_loadu_pd(&a[s[0]]);
+    return _mm_set_pd(a[s[1]], a[s[0]]);
+}
+
+template <>
+size_t TriangleStore::findFirstHit(const Vec3 &center, double radius, const size_t *slots, size_t count) const
+{
+    const __m128d cx = _mm_set1_pd(center.x);
+    const __m128d cy = _mm_set1_pd(center.y);
+    const __m128d cz = _mm_set1_pd(center.z);
+    const __m128d r = _mm_set1_pd(radius);
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d zero = _mm_set1_pd(-0.0);
+    const __m128d one = _mm_set1_pd(1.0);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const size_t *s = slots + i;
+        bool consecutive = areConsecutive(s, 2);
+
+        __m128d pax = load2(ax, s, consecutive);
+        __m128d pay = load2(ay, s, consecutive);
+        __m128d paz = load2(az, s, consecutive);
+        __m128d pnx = load2(nx, s, consecutive);
+        __m128d pny = load2(ny, s, consecutive);
+        __m128d pnz = load2(nz, s, consecutive);
+
+        // distance to the plane
+        __m128d dx = _mm_sub_pd(cx, pax);
+        __m128d dy = _mm_sub_pd(cy, pay);
+        __m128d dz = _mm_sub_pd(cz, paz);
+        __m128d newDist = _mm_add_pd(_mm_add_pd(_mm_mul_pd(pnx, dx), _mm_mul_pd(pny, dy)), _mm_mul_pd(pnz, dz));
+        __m128d dist = _mm_andnot_pd(signMask, newDist);
+        // not (dist > radius), true for nan like the scalar check
+        int planeBits = _mm_movemask_pd(_mm_cmpngt_pd(dist, r));
+        if (planeBits == 0)
+            continue;
+
+        int faceBits = faceOnly[s[0]] | (faceOnly[s[1]] << 1);
+
+        // barycentric coordinates of the closest point on the plane
+        __m128d v2x = _mm_sub_pd(_mm_sub_pd(cx, _mm_mul_pd(pnx, newDist)), pax);
+        __m128d v2y = _mm_sub_pd(_mm_sub_pd(cy, _mm_mul_pd(pny, newDist)), pay);
+        __m128d v2z = _mm_sub_pd(_mm_sub_pd(cz, _mm_mul_pd(pnz, newDist)), paz);
+        __m128d dot02 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(load2(v0x, s, consecutive), v2x), _mm_mul_pd(load2(v0y, s, consecutive), v2y)), _mm_mul_pd(load2(v0z, s, consecutive), v2z));
+        __m128d dot12 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(load2(v1x, s, consecutive), v2x), _mm_mul_pd(load2(v1y, s, consecutive), v2y)), _mm_mul_pd(load2(v1z, s, consecutive), v2z));
+        __m128d d00 = load2(dot00, s, consecutive);
+        __m128d d01 = load2(dot01, s, consecutive);
+        __m128d d11 = load2(dot11, s, consecutive);
+        __m128d inv = load2(invDenom, s, consecutive);
+        __m128d u = _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(d11, dot02), _mm_mul_pd(d01, dot12)), inv);
+        __m128d v = _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(d00, dot12), _mm_mul_pd(d01, dot02)), inv);
+        __m128d inside = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(u, zero), _mm_cmpge_pd(v, zero)),
+                                    _mm_cmple_pd(_mm_add_pd(u, v), one));
+        int insideBits = _mm_movemask_pd(inside);
+
+        int hitBits = planeBits & (~faceBits | insideBits) & 0x3;
+        if (hitBits != 0)
+            return i + ((hitBits & 1) ? 0 : 1);
+    }
+
+    return testScalar(center, radius, slots, i, count);
+}
+
+// loads 4 values, directly if the slots are consecutive
+static inline __m128 load4(const std::vector<float> &a, const size_t *s, bool consecutive)
+{
+    if (consecutive)
+        return _mm_loadu_ps(&a[s[0]]);
+    return _mm_set_ps(a[s[3]], a[s[2]], a[s[1]], a[s[0]]);
+}
+
+template <>
+size_t FloatTriangleStore::findFirstHit(const Vec3 &center, double radius, const size_t *slots, size_t count) const
+{
+    const __m128 cx = _mm_set1_ps(static_cast<float>(center.x));
+    const __m128 cy = _mm_set1_ps(static_cast<float>(center.y));
+    const __m128 cz = _mm_set1_ps(static_cast<float>(center.z));
+    const __m128 r = _mm_set1_ps(static_cast<float>(radius) + tolerance);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_set1_ps(-tolerance);
+    const __m128 one = _mm_set1_ps(1.0f + tolerance);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const size_t *s = slots + i;
+        bool consecutive = areConsecutive(s, 4);
+
+        __m128 pax = load4(ax, s, consecutive);
+        __m128 pay = load4(ay, s, consecutive);
+        __m128 paz = load4(az, s, consecutive);
+        __m128 pnx = load4(nx, s, consecutive);
+        __m128 pny = load4(ny, s, consecutive);
+        __m128 pnz = load4(nz, s, consecutive);
+
+        // distance to the plane
+        __m128 dx = _mm_sub_ps(cx, pax);
+        __m128 dy = _mm_sub_ps(cy, pay);
+        __m128 dz = _mm_sub_ps(cz, paz);
+        __m128 newDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pnx, dx), _mm_mul_ps(pny, dy)), _mm_mul_ps(pnz, dz));
+        __m128 dist = _mm_andnot_ps(signMask, newDist);
+        int planeBits = _mm_movemask_ps(_mm_cmpngt_ps(dist, r));
+        if (planeBits == 0)
+            continue;
+
+        int faceBits = faceOnly[s[0]] | (faceOnly[s[1]] << 1) | (faceOnly[s[2]] << 2) | (faceOnly[s[3]] << 3);
+
+        // barycentric coordinates of the closest point on the plane
+        __m128 v2x = _mm_sub_ps(_mm_sub_ps(cx, _mm_mul_ps(pnx, newDist)), pax);
+        __m128 v2y = _mm_sub_ps(_mm_sub_ps(cy, _mm_mul_ps(pny, newDist)), pay);
+        __m128 v2z = _mm_sub_ps(_mm_sub_ps(cz, _mm_mul_ps(pnz, newDist)), paz);
+        __m128 dot02 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(load4(v0x, s, consecutive), v2x), _mm_mul_ps(load4(v0y, s, consecutive), v2y)), _mm_mul_ps(load4(v0z, s, consecutive), v2z));
+        __m128 dot12 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(load4(v1x, s, consecutive), v2x), _mm_mul_ps(load4(v1y, s, consecutive), v2y)), _mm_mul_ps(load4(v1z, s, consecutive), v2z));
+        __m128 d00 = load4(dot00, s, consecutive);
+        __m128 d01 = load4(dot01, s, consecutive);
+        __m128 d11 = load4(dot11, s, consecutive);
+        __m128 inv = load4(invDenom, s, consecutive);
+        __m128 u = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(d11, dot02), _mm_mul_ps(d01, dot12)), inv);
+        __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(d00, dot12), _mm_mul_ps(d01, dot02)), inv);
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)),
+                                   _mm_cmple_ps(_mm_add_ps(u, v), one));
+        int insideBits = _mm_movemask_ps(inside);
+
+        int hitBits = planeBits & (~faceBits | insideBits) & 0xF;
+        for (int k = 0; k < 4; k++)
+        {
+            if (hitBits & (1 << k))
+                return i + k;
+        }
+    }
+
+    return testScalar(center, radius, slots, i, count);
+}
+
+template <typename T>
+const char *BasicTriangleStore<T>::getKernelName()
+{
+    return "sse2";
+}
+
+#else
+
+template <>
+size_t TriangleStore::findFirstHit(const Vec3 &center, double radius, const size_t *slots, size_t count) const
+{
+    return testScalar(center, radius, slots, 0, count);
+}
+
+template <>
+size_t FloatTriangleStore::findFirstHit(const Vec3 &center, double radius, const size_t *slots, size_t count) const
+{
+    return testScalar(center, radius, slots, 0, count);
+}
+
+template <typename T>
+const char *BasicTriangleStore<T>::getKernelName()
+{
+    return "scalar";
+}
+
+#endif
+
+template class BasicTriangleStore<double>;
+template class BasicTriangleStore<float>;
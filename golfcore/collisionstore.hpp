@@ -0,0 +1,63 @@
+#ifndef COLLISIONSTORE_HPP
+#define COLLISIONSTORE_HPP
+
+#include <vector>
+#include <cstdint>
+#include "simulation.hpp"
+
+// scalar type of the triangle store a course tests balls against
+enum class CollisionPrecision
+{
+    // exact early out of Triangle::findContacts, for reference runs
+    DOUBLE,
+    // half the memory and twice the triangles per SIMD instruction, for batch runs
+    FLOAT
+};
+
+// Static triangles of a course flattened into structure of arrays
+// Used to test one sphere against many triangles at once with SIMD (AVX2, SSE2 or scalar fallback).
+// The test is the early out part of Triangle::findContacts with the same operations in the same order:
+// a triangle is a hit if Triangle::findContacts could add a contact for the sphere.
+// Course::findContacts then calls Triangle::findContacts on the hits only, and the manifold is solved as before,
+// so results match testing every triangle exactly.
+// With T = float the test is widened by tolerance, so it finds every triangle the double test finds
+// and a few close misses, for which Triangle::findContacts adds no contact. Results stay the same.
+template <typename T>
+class BasicTriangleStore
+{
+private:
+    // first corner
+    std::vector<T> ax, ay, az;
+    // unit normal
+    std::vector<T> nx, ny, nz;
+    // barycentric terms, see BakedTriangle
+    std::vector<T> v0x, v0y, v0z;
+    std::vector<T> v1x, v1y, v1z;
+    std::vector<T> dot00, dot01, dot11, invDenom;
+    std::vector<uint8_t> faceOnly;
+    std::vector<Triangle*> triangles;
+
+    size_t testScalar(const Vec3& center, double radius, const size_t* slots, size_t first, size_t count) const;
+
+public:
+    // added to the distance and barycentric limits, far above the rounding error of course sized coordinates
+    static constexpr T tolerance = sizeof(T) < sizeof(double) ? T(1e-3) : T(0);
+
+    void clear();
+    // adds the triangle with its current baked data, returns its slot
+    // the triangle must not move afterwards
+    size_t add(Triangle& triangle);
+    size_t size() const { return triangles.size(); }
+    Triangle* getTriangle(size_t slot) const { return triangles[slot]; }
+
+    // tests the sphere against the triangles at slots[0] ... slots[count-1]
+    // returns the index into slots of the first hit, or count if there is none
+    size_t findFirstHit(const Vec3& center, double radius, const size_t* slots, size_t count) const;
+    // name of the kernel this build uses
+    static const char* getKernelName();
+};
+
+using TriangleStore = BasicTriangleStore<double>;
+using FloatTriangleStore = BasicTriangleStore<float>;
+
+#endif // COLLISIONSTORE_HPP
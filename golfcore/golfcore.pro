@@ -0,0 +1,51 @@
+#-------------------------------------------------
+#
+# Headless physics and game library
+# no widgets and no OpenGL, can run without a display
+#
+#-------------------------------------------------
+
+TEMPLATE = lib
+CONFIG  += staticlib c++17 thread
+TARGET   = golfcore
+
+# plain C++, does not link against Qt
+CONFIG  -= qt
+
+# keep a*b+c as two roundings so the SIMD kernels match the scalar code
+# build with CONFIG+=avx2 to use the AVX2 collision kernel, SSE2 is used otherwise
+gcc|clang: QMAKE_CXXFLAGS += -ffp-contract=off
+avx2 {
+    gcc|clang: QMAKE_CXXFLAGS += -mavx2
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+}
+
+# build with CONFIG+=count_allocations to count every operator new, see allocationcounter.hpp
+count_allocations: DEFINES += GOLF_COUNT_ALLOCATIONS
+
+SOURCES += allocationcounter.cpp \
+           arena.cpp \
+           collisionstore.cpp \
+           meshbuilder.cpp \
+           minigolf.cpp \
+           obstacles.cpp \
+           shotevaluator.cpp \
+           simulation.cpp \
+           spatialindex.cpp \
+           threadpool.cpp
+
+HEADERS += allocationcounter.hpp \
+           arena.hpp \
+           collisionstore.hpp \
+           meshbuilder.hpp \
+           minigolf.hpp \
+           obstacles.hpp \
+           quaternion.hpp \
+           renderer.hpp \
+           shotevaluator.hpp \
+           simulation.hpp \
+           spatialindex.hpp \
+           spscqueue.hpp \
+           threadpool.hpp \
+           triplebuffer.hpp \
+           vec3.hpp
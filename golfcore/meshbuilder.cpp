@@ -0,0 +1,192 @@
+#include "meshbuilder.hpp"
+#include <cmath>
+
+std::vector<unsigned int> &MeshBuilder::getColorIndices(const Vec3 &color)
+{
+    // courses use a handful of colors, a linear search is enough
+    for (size_t i = 0; i < colors.size(); i++)
+    {
+        if (colors[i].x == color.x && colors[i].y == color.y && colors[i].z == color.z)
+            return colorIndices[i];
+    }
+    colors.push_back(color);
+    colorIndices.emplace_back();
+    return colorIndices.back();
+}
+
+unsigned int MeshBuilder::addVertex(const Vec3 &position, const Vec3 &normal)
+{
+    Vec3 p = offset + position;
+    vertices.push_back({{static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z)},
+                        {static_cast<float>(normal.x), static_cast<float>(normal.y), static_cast<float>(normal.z)}});
+    return static_cast<unsigned int>(vertices.size() - 1);
+}
+
+void MeshBuilder::addPolygon(const Vec3 *corners, size_t count, const Vec3 &normal, const Vec3 &color)
+{
+    std::vector<unsigned int> &target = getColorIndices(color);
+    unsigned int first = addVertex(corners[0], normal);
+    unsigned int previous = addVertex(corners[1], normal);
+    for (size_t i = 2; i < count; i++)
+    {
+        unsigned int current = addVertex(corners[i], normal);
+        target.push_back(first);
+        target.push_back(previous);
+        target.push_back(current);
+        previous = current;
+    }
+}
+
+void MeshBuilder::clear()
+{
+    transforms.clear();
+    offset = Vec3(0);
+    vertices.clear();
+    colors.clear();
+    colorIndices.clear();
+    indices.clear();
+    batches.clear();
+    spheres.clear();
+}
+
+void MeshBuilder::finish()
+{
+    indices.clear();
+    batches.clear();
+    for (size_t i = 0; i < colors.size(); i++)
+    {
+        if (colorIndices[i].empty())
+            continue;
+        batches.push_back({colors[i], indices.size(), colorIndices[i].size()});
+        indices.insert(indices.end(), colorIndices[i].begin(), colorIndices[i].end());
+    }
+}
+
+void MeshBuilder::pushTransform(const Vec3 &translation)
+{
+    transforms.push_back(offset);
+    offset += translation;
+}
+
+void MeshBuilder::popTransform()
+{
+    offset = transforms.back();
+    transforms.pop_back();
+}
+
+void MeshBuilder::drawTriangle(Triangle &triangle)
+{
+    auto &position = triangle.getPosition();
+    auto corners = triangle.getCorners();
+    Vec3 placed[3] = {position + corners[0], position + corners[1], position + corners[2]};
+    addPolygon(placed, 3, triangle.getNormal(), triangle.getColor());
+}
+
+void MeshBuilder::drawWall(Wall &wall)
+{
+    auto &position = wall.getPosition();
+    auto &corners = wall.getCorners();
+    Vec3 placed[4] = {position + corners[0], position + corners[1], position + corners[2], position + corners[3]};
+    addPolygon(placed, 4, wall.getNormal(), wall.getColor());
+}
+
+void MeshBuilder::drawPolygon(ConvexPolygon &polygon)
+{
+    auto &position = polygon.getPosition();
+    std::vector<Vec3> placed;
+    for (const auto &corner : polygon.getCorners())
+    {
+        placed.push_back(position + corner);
+    }
+    addPolygon(placed.data(), placed.size(), polygon.getNormal(), polygon.getColor());
+}
+
+void MeshBuilder::drawSphere(Sphere &sphere)
+{
+    spheres.push_back({&sphere, offset});
+}
+
+void MeshBuilder::drawBox(Box &box)
+{
+    auto &walls = box.getWalls();
+    size_t outerWallCount = box.getOuterWallCount();
+
+    pushTransform(box.getPosition());
+
+    // floor, a fan from the origin over the first corners of the outer walls like GLRenderer::drawBox
+    std::vector<Vec3> floor;
+    floor.push_back(Vec3(0));
+    for (size_t i = 0; i <= outerWallCount; i++)
+    {
+        floor.push_back(walls[i % outerWallCount].getCorners()[0]);
+    }
+    addPolygon(floor.data(), floor.size(), Vec3(0, 1, 0), Vec3(0.5, 0.5, 0.5));
+
+    for (Wall &wall : walls)
+    {
+        wall.draw(*this);
+    }
+
+    popTransform();
+}
+
+void MeshBuilder::drawHeightfield(Heightfield &heightfield)
+{
+    const auto &samples = heightfield.getVertices();
+    const auto &normals = heightfield.getNormals();
+    const auto &strip = heightfield.getStripIndices();
+    std::vector<unsigned int> &target = getColorIndices(heightfield.getColor());
+
+    pushTransform(heightfield.getPosition());
+    unsigned int first = static_cast<unsigned int>(vertices.size());
+    for (size_t i = 0; i < samples.size(); i += 3)
+    {
+        addVertex(Vec3(samples[i], samples[i + 1], samples[i + 2]), Vec3(normals[i], normals[i + 1], normals[i + 2]));
+    }
+    popTransform();
+
+    // the strip as a triangle list, every other triangle is turned back, the joins between columns are dropped
+    for (size_t i = 2; i < strip.size(); i++)
+    {
+        unsigned int a = strip[i - 2], b = strip[i - 1], c = strip[i];
+        if (a == b || b == c || a == c)
+            continue;
+        if (i % 2 == 1)
+            std::swap(a, b);
+        target.push_back(first + a);
+        target.push_back(first + b);
+        target.push_back(first + c);
+    }
+}
+
+void MeshBuilder::buildSphere(int resolution, std::vector<SphereVertex> &vertices, std::vector<unsigned int> &indices)
+{
+    vertices.clear();
+    indices.clear();
+    double step = PI / resolution;
+    // 2 * resolution + 1 points around, the last one closes the band
+    unsigned int around = 2 * resolution + 1;
+    for (int band = 0; band < resolution; band++)
+    {
+        float stripe = static_cast<float>(band % 2);
+        unsigned int top = static_cast<unsigned int>(vertices.size());
+        for (int ring = band; ring <= band + 1; ring++)
+        {
+            double beta = ring * step;
+            for (unsigned int i = 0; i < around; i++)
+            {
+                double alpha = i * step;
+                vertices.push_back({{static_cast<float>(std::sin(beta) * std::cos(alpha)),
+                                     static_cast<float>(std::sin(beta) * std::sin(alpha)),
+                                     static_cast<float>(std::cos(beta))},
+                                    stripe});
+            }
+        }
+        unsigned int bottom = top + around;
+        for (unsigned int i = 0; i + 1 < around; i++)
+        {
+            indices.insert(indices.end(), {top + i, bottom + i, top + i + 1});
+            indices.insert(indices.end(), {top + i + 1, bottom + i, bottom + i + 1});
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef MESHBUILDER_HPP
+#define MESHBUILDER_HPP
+
+#include <vector>
+#include "renderer.hpp"
+#include "simulation.hpp"
+
+// Collects what objects draw into one triangle mesh, grouped by color
+// Renderers use it to upload geometry that does not change once (see Renderer::drawStatic)
+// and draw it with a few calls per frame instead of one per object.
+// Corners are in the space of the first pushTransform, normals are those the objects draw with.
+class MeshBuilder : public Renderer
+{
+public:
+    struct Vertex
+    {
+        float position[3];
+        float normal[3];
+    };
+
+    // triangles of one color, indices[firstIndex] ... indices[firstIndex + indexCount - 1]
+    struct Batch
+    {
+        Vec3 color;
+        size_t firstIndex;
+        size_t indexCount;
+    };
+
+    // vertex of the unit sphere that balls are drawn with, the normal is the position
+    struct SphereVertex
+    {
+        float position[3];
+        // 0 in the bands with the color of the ball, 1 in the stripes between them
+        float stripe;
+    };
+
+    // spheres are not merged, they are drawn with their stripes and rotation every frame
+    struct PlacedSphere
+    {
+        Sphere *sphere;
+        // sum of the transforms it was drawn in
+        Vec3 offset;
+    };
+
+private:
+    std::vector<Vec3> transforms;
+    Vec3 offset = Vec3(0);
+    std::vector<Vertex> vertices;
+    // indices per color until finish() puts them one after the other
+    std::vector<Vec3> colors;
+    std::vector<std::vector<unsigned int>> colorIndices;
+    std::vector<unsigned int> indices;
+    std::vector<Batch> batches;
+    std::vector<PlacedSphere> spheres;
+
+    std::vector<unsigned int> &getColorIndices(const Vec3 &color);
+    unsigned int addVertex(const Vec3 &position, const Vec3 &normal);
+    // a convex polygon as a fan around its first corner
+    void addPolygon(const Vec3 *corners, size_t count, const Vec3 &normal, const Vec3 &color);
+
+public:
+    // forgets everything drawn so far, keeps the memory
+    void clear();
+    // puts the triangles of each color together into batches, call after drawing
+    void finish();
+
+    const std::vector<Vertex> &getVertices() const { return vertices; }
+    const std::vector<unsigned int> &getIndices() const { return indices; }
+    const std::vector<Batch> &getBatches() const { return batches; }
+    const std::vector<PlacedSphere> &getSpheres() const { return spheres; }
+
+    // unit sphere around the origin as a triangle list, resolution bands from pole to pole along z
+    // every band has its own vertices, so a band can be colored as a whole
+    static void buildSphere(int resolution, std::vector<SphereVertex> &vertices, std::vector<unsigned int> &indices);
+
+    void pushTransform(const Vec3 &translation);
+    void popTransform();
+
+    void drawTriangle(Triangle &triangle);
+    void drawWall(Wall &wall);
+    void drawPolygon(ConvexPolygon &polygon);
+    void drawSphere(Sphere &sphere);
+    void drawBox(Box &box);
+    void drawHeightfield(Heightfield &heightfield);
+
+    // flags and lines are no course geometry, they are left out
+    void drawHole(const Vec3 &) {}
+    void drawLine(const Vec3 &, const Vec3 &, const Vec3 &, float) {}
+};
+
+#endif // MESHBUILDER_HPP
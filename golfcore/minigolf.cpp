@@ -0,0 +1,1223 @@
+
+#include "minigolf.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <obstacles.hpp>
+#include "allocationcounter.hpp"
+
+namespace golf {
+
+    // a static library only links the object files something refers to,
+    // without this reference a build with count_allocations would silently keep the default operator new
+    [[maybe_unused]] static const bool countingAllocations = isCountingAllocations();
+
+    const std::string getScoreTerm(int score, int par) {
+        int diff = score - par;
+        if (score == 1) return "hole in one";
+        if(diff == 0) return "par";
+        if(diff == -1) return "birdie";
+        if(diff == -2) return "eagle";
+        if(diff <= -3) return "albatross";
+        if(diff == 1) return "bogey";
+        if(diff == 2) return "double bogey";
+        if(diff == 3) return "triple bogey";
+
+        return std::to_string(score) + " strokes";
+    }
+
+    Player::Player(const std::string& name) : name(name), ball() {
+
+    }
+
+
+    void Player::startHole() {
+        startedHole = true;
+        //ball.setVelocity(Vec3(2,0,2));
+    }
+
+    void Player::reset(Vec3 position) {
+        ball.setPosition(position);
+        ball.setVelocity(Vec3(0));
+        ball.wake();
+        strokes = 0;
+        finishedHole = false;
+        startedHole = false;
+    }
+
+    void Player::resetAll() {
+        reset(Vec3(0));
+        score = 0;
+    }
+
+    static std::atomic<unsigned long long> nextCourseId{1};
+
+    Course::Course(Game& game, Vec3 holePosition, Vec3 startPosition) : SimObject(), game(game), holePosition(holePosition), startPosition(startPosition), id(nextCourseId++) {
+
+        // reset all players
+        for (Player& player : game.getPlayers()) {
+            player.reset(startPosition);
+        }
+    }
+
+    void Course::draw(Renderer& renderer) {
+        std::vector<ObjectTransform> movingTransforms;
+        getMovingTransforms(movingTransforms);
+        draw(renderer, movingTransforms);
+    }
+
+    void Course::draw(Renderer& renderer, const std::vector<ObjectTransform>& movingTransforms) {
+        // the static children never change after construction, a renderer can keep them
+        renderer.drawStatic(id, [this](Renderer& staticRenderer) {
+            staticRenderer.pushTransform(position);
+            for (SimObject* child : children) {
+                if (std::find(movingChildren.begin(), movingChildren.end(), child) == movingChildren.end())
+                    child->draw(staticRenderer);
+            }
+            staticRenderer.popTransform();
+        });
+
+        renderer.pushTransform(position);
+        for (size_t i = 0; i < movingChildren.size(); i++) {
+            movingChildren[i]->drawChildrenAt(renderer, movingTransforms[i].position);
+        }
+        renderer.popTransform();
+
+        renderer.drawHole(holePosition);
+    }
+
+    void Course::getMovingTransforms(std::vector<ObjectTransform>& transforms) {
+        transforms.resize(movingChildren.size());
+        for (size_t i = 0; i < movingChildren.size(); i++) {
+            transforms[i].position = movingChildren[i]->getPosition();
+        }
+    }
+
+    void Course::addMovingChild(SimObject* child) {
+        addChild(child);
+        movingChildren.push_back(child);
+    }
+
+    // buffers of findContacts and sweep, kept between calls so they do not allocate once they are large enough
+    // one set per thread, since balls are collided in parallel
+    struct CollisionScratch {
+        std::vector<size_t> nearby;
+        std::vector<size_t> slots;
+    };
+    static thread_local CollisionScratch collisionScratch;
+
+    // makes room for the largest query up front, so a later query never grows the buffers
+    static void reserveCollisionScratch(size_t size) {
+        if (collisionScratch.nearby.capacity() < size) {
+            collisionScratch.nearby.reserve(size);
+            collisionScratch.slots.reserve(size);
+        }
+    }
+
+    void Course::findContacts(Sphere& sphere, ContactManifold& manifold) {
+        if (index == nullptr) {
+            SimObject::findContacts(sphere, manifold);
+            return;
+        }
+
+        // only visit children near the ball, in the same order as above
+        // the ball does not move until all contacts are found, so one query covers them
+        AABB area = sphere.getBounds();
+        std::vector<size_t>& nearby = collisionScratch.nearby;
+        std::vector<size_t>& slots = collisionScratch.slots;
+        reserveCollisionScratch(maxNearby);
+        nearby.clear();
+        queryChildren(area, nearby);
+        size_t i = 0;
+        while (i < nearby.size()) {
+            size_t id = nearby[i];
+            if (storeSlots[id] != SIZE_MAX) {
+                // test the following triangles together, skip to the first one that is hit
+                size_t end = i;
+                slots.clear();
+                while (end < nearby.size() && storeSlots[nearby[end]] != SIZE_MAX) {
+                    slots.push_back(storeSlots[nearby[end]]);
+                    end++;
+                }
+                size_t hit = collisionPrecision == CollisionPrecision::FLOAT
+                    ? floatTriangleStore.findFirstHit(sphere.getWorldPosition(), sphere.getRadius(), slots.data(), slots.size())
+                    : triangleStore.findFirstHit(sphere.getWorldPosition(), sphere.getRadius(), slots.data(), slots.size());
+                if (hit == slots.size()) {
+                    i = end;
+                    continue;
+                }
+                i += hit;
+                id = nearby[i];
+            }
+
+            children[id]->findContacts(sphere, manifold);
+            i++;
+        }
+    }
+
+    double Course::sweep(Sphere& sphere, const Vec3& motion) {
+        if (index == nullptr) {
+            return SimObject::sweep(sphere, motion);
+        }
+
+        // everything the ball could touch on the way
+        AABB area = sphere.getBounds();
+        area.expand(AABB(area.min + motion, area.max + motion));
+        std::vector<size_t>& nearby = collisionScratch.nearby;
+        reserveCollisionScratch(maxNearby);
+        nearby.clear();
+        queryChildren(area, nearby);
+
+        double t = INFINITY;
+        for (size_t id : nearby) {
+            t = std::min(t, children[id]->sweep(sphere, motion));
+        }
+        return t;
+    }
+
+    // a flat loop of welded corners, in order around its normal
+    struct MergeFace {
+        std::vector<size_t> loop;
+        Vec3 normal;
+        double offset;
+        std::vector<SimObject*> tiles;
+    };
+
+    // whether the turn from a to b to c does not bend outward around normal, straight counts as convex
+    static double getTurn(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& normal) {
+        return (b - a).cross(c - b).dot(normal);
+    }
+
+    // joins b into a if they share an edge and the result is convex
+    static bool mergeFaces(MergeFace& a, const MergeFace& b, const std::vector<Vec3>& vertices) {
+        size_t na = a.loop.size(), nb = b.loop.size();
+        for (size_t k = 0; k < na; k++) {
+            for (size_t m = 0; m < nb; m++) {
+                // the shared edge runs in opposite directions in both loops
+                if (a.loop[k] != b.loop[(m + 1) % nb] || a.loop[(k + 1) % na] != b.loop[m]) continue;
+
+                // a from the end of the edge around to its start, then the rest of b
+                std::vector<size_t> loop;
+                for (size_t i = 1; i <= na; i++) loop.push_back(a.loop[(k + i) % na]);
+                for (size_t i = 2; i < nb; i++) loop.push_back(b.loop[(m + i) % nb]);
+
+                std::vector<size_t> convex;
+                for (size_t i = 0; i < loop.size(); i++) {
+                    const Vec3& previous = vertices[loop[(i + loop.size() - 1) % loop.size()]];
+                    const Vec3& current = vertices[loop[i]];
+                    const Vec3& next = vertices[loop[(i + 1) % loop.size()]];
+                    double turn = getTurn(previous, current, next, a.normal);
+                    double scale = (current - previous).length() * (next - current).length();
+                    if (turn < -1e-9 * scale) return false;
+                    // corners on a straight edge are dropped
+                    if (turn > 1e-9 * scale) convex.push_back(loop[i]);
+                }
+                a.loop = convex;
+                a.tiles.insert(a.tiles.end(), b.tiles.begin(), b.tiles.end());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Course::mergeGroundTiles() {
+        std::vector<Vec3> vertices;
+        auto weld = [&](const Vec3& p) {
+            for (size_t i = 0; i < vertices.size(); i++) {
+                if (vertices[i].getDistance(p) < weldDistance) return i;
+            }
+            vertices.push_back(p);
+            return vertices.size() - 1;
+        };
+
+        // every static tile as a face, turned so its normal points up
+        std::vector<MergeFace> faces;
+        Vec3 origin = getWorldPosition();
+        for (SimObject* child : children) {
+            GroundTile* tile = dynamic_cast<GroundTile*>(child);
+            if (tile == nullptr) continue;
+            if (std::find(movingChildren.begin(), movingChildren.end(), child) != movingChildren.end()) continue;
+            MergeFace face;
+            for (const Vec3& corner : tile->getWorldCorners()) {
+                face.loop.push_back(weld(corner - origin));
+            }
+            const Vec3& a = vertices[face.loop[0]];
+            face.normal = a.getNormal(vertices[face.loop[1]], vertices[face.loop[2]]);
+            if (face.normal.y < 0) {
+                std::reverse(face.loop.begin(), face.loop.end());
+                face.normal = -face.normal;
+            }
+            face.offset = face.normal.dot(a);
+            face.tiles.push_back(tile);
+            faces.push_back(face);
+        }
+
+        // merge faces of the same plane until no more pairs can be merged
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (size_t i = 0; i < faces.size(); i++) {
+                for (size_t j = i + 1; j < faces.size(); j++) {
+                    if (faces[i].normal.dot(faces[j].normal) < 1 - 1e-9) continue;
+                    if (std::abs(faces[i].offset - faces[j].offset) > weldDistance) continue;
+                    if (!mergeFaces(faces[i], faces[j], vertices)) continue;
+                    faces.erase(faces.begin() + j);
+                    merged = true;
+                    j--;
+                }
+            }
+        }
+
+        // faces made of several tiles take the place of the first of them, so the collision order stays the same
+        // the tiles stay in the arena but are not children anymore
+        for (const MergeFace& face : faces) {
+            if (face.tiles.size() < 2) continue;
+            size_t first = children.size();
+            for (SimObject* tile : face.tiles) {
+                auto it = std::find(children.begin(), children.end(), tile);
+                first = std::min(first, static_cast<size_t>(it - children.begin()));
+                children.erase(it);
+            }
+            std::vector<Vec3> corners;
+            for (size_t id : face.loop) {
+                corners.push_back(vertices[id]);
+            }
+            addChild(arena.create<GroundPolygon>(corners));
+            std::rotate(children.begin() + first, children.end() - 1, children.end());
+        }
+    }
+
+    void Course::buildIndex(SpatialIndexType type, CollisionPrecision precision) {
+        mergeGroundTiles();
+
+        // moving children are refit on their own, so the index never changes after this
+        std::vector<AABB> bounds;
+        staticChildIds.clear();
+        movingChildIds.clear();
+        movingBounds.clear();
+        for (size_t i = 0; i < children.size(); i++) {
+            if (std::find(movingChildren.begin(), movingChildren.end(), children[i]) != movingChildren.end()) {
+                movingChildIds.push_back(i);
+                movingBounds.push_back(children[i]->getBounds());
+            } else {
+                staticChildIds.push_back(i);
+                bounds.push_back(children[i]->getBounds());
+            }
+        }
+        index = createSpatialIndex(type);
+        index->build(bounds);
+        maxNearby = index->getMaxQuerySize() + movingChildIds.size();
+
+        collisionPrecision = precision;
+        triangleStore.clear();
+        floatTriangleStore.clear();
+        storeSlots.assign(children.size(), SIZE_MAX);
+        for (size_t i : staticChildIds) {
+            Triangle* triangle = dynamic_cast<Triangle*>(children[i]);
+            if (triangle != nullptr) {
+                storeSlots[i] = precision == CollisionPrecision::FLOAT ? floatTriangleStore.add(*triangle) : triangleStore.add(*triangle);
+            }
+        }
+    }
+
+    void Course::updateIndex(SimObject* child) {
+        // reading the bounds also brings the world transforms of the moved child up to date
+        // before balls read them in parallel
+        AABB bounds = child->getBounds();
+        movedArea.expand(bounds);
+        for (size_t i = 0; i < movingChildIds.size(); i++) {
+            if (children[movingChildIds[i]] == child) movingBounds[i] = bounds;
+        }
+    }
+
+    void Course::queryChildren(const AABB& area, std::vector<size_t>& result) const {
+        size_t start = result.size();
+        index->query(area, result);
+        // staticChildIds is ascending, so the children stay sorted
+        for (size_t i = start; i < result.size(); i++) {
+            result[i] = staticChildIds[result[i]];
+        }
+        for (size_t i = 0; i < movingChildIds.size(); i++) {
+            if (!movingBounds[i].overlaps(area)) continue;
+            // insert in order, there are only a few moving children
+            result.push_back(movingChildIds[i]);
+            for (size_t j = result.size() - 1; j > start && result[j - 1] > result[j]; j--) {
+                std::swap(result[j - 1], result[j]);
+            }
+        }
+    }
+
+    void Course::tick(unsigned long long time) {
+
+        checkHole();
+
+    }
+
+    void Course::checkHole() {
+        // check if any player is in the hole
+
+        for (Player& player : game.getPlayers()) {
+            if(player.hasFinishedHole()) continue;
+            if (isInHole(player.getBall())) {
+                // player is in hole
+                std::cout << getScoreTerm(player.getStrokes(), par) << "!" << std::endl;
+                std::cout << player.getName() << " is in the hole!" << std::endl;
+                player.setFinishedHole(true);
+                player.getBall().setPosition(Vec3(-1000, -1000, -1000));
+                player.setScore(player.getScore() + player.getStrokes());
+            }
+        }
+    }
+
+    Wall* Course::buildWallOnGround(double x1, double z1, double x2, double z2, double height, std::function<double(double, double)> heightFunction) {
+
+        double y1 = heightFunction(x1, z1);
+        double y2 = heightFunction(x2, z2);
+
+
+        // TODO: somewhere nan for some reason
+        Vec3 c1 = Vec3(x1+0.001, y1-height/2+0.001, z1+0.001);
+        Vec3 c2 = Vec3(x1+0.002, y1+height+0.002, z1+0.002);
+        Vec3 c3 = Vec3(x2+0.003, y2+height+0.003, z2+0.003);
+        Vec3 c4 = Vec3(x2+0.004, y2-height/2+0.004, z2+0.004);
+
+        Wall* wall = arena.create<Wall>(c1, c2, c3, c4);
+        return wall;
+    }
+
+    std::vector<Wall*> Course::buildWallsOnGround(const std::vector<double>& xz, double height, std::function<double(double, double)> heightFunction) {
+
+        std::vector<Wall*> walls;
+
+        for (size_t i = 0; i < xz.size(); i += 2) {
+            walls.push_back(buildWallOnGround(xz[i], xz[i+1], xz[(i+2)%xz.size()], xz[(i+3)%xz.size()], height, heightFunction));
+        }
+
+        return walls;
+    }
+
+    CourseA8::CourseA8(Game& game) : Course(game, Vec3(4, 0, 8), Vec3(0, 1, 0)) {
+        // set hole radius
+        holeRadius = 0.5;
+
+        // par
+        par = 2;
+
+        // add walls
+        Box b({-2,-2, -2, 6, 2, 6, 2, 10, 6, 10, 6, 2, 2, 2, 2, -2});
+        for (Wall& wall : b.getWalls()) {
+            addChild(arena.create<Wall>(wall));
+        }
+
+        // create floor
+        Vec3 p1(-2, -2);
+        Vec3 p2(-2, 6);
+        Vec3 p3(2, 6);
+        Vec3 p4(2, 10);
+        Vec3 p5(6, 10);
+        Vec3 p6(6, 2);
+        Vec3 p7(2, 2);
+        Vec3 p8(2, -2);
+        addChild(arena.create<GroundTile>(p1, p2, p3));
+        addChild(arena.create<GroundTile>(p4, p5, p6));
+        addChild(arena.create<GroundTile>(p7, p4, p6));
+        addChild(arena.create<GroundTile>(p1, p8, p3));
+
+        // add obstacles
+        addChild(arena.create<Pillar>(arena, Vec3(5, 0, 7), 0.5, 4));
+
+
+    }
+
+    Course2::Course2(Game& game) : Course(game, Vec3(2.5, 0, -2), Vec3(-4, 0.5, -1.5)) {
+        // set hole radius
+        holeRadius = 0.4;
+
+        // par
+        par = 3;
+
+        // add walls
+        Box b({-2,0, -2, 3, 4, 3, 4, -3, -5, -3, -5, 0});
+        for (Wall& wall : b.getWalls()) {
+            addChild(arena.create<Wall>(wall));
+        }
+
+        addChild(arena.create<Wall>(1, 0, 1, -3));
+
+        // create floor
+        Vec3 p1(4, 3);
+        Vec3 p2(4, -3);
+        Vec3 p3(-2, -3);
+        Vec3 p4(-2, 3);
+        Vec3 p5(-2, 0);
+        Vec3 p6(-5, 0);
+        Vec3 p7(-5, -3);
+        addChild(arena.create<GroundTile>(p1, p2, p3));
+        addChild(arena.create<GroundTile>(p3, p4, p1));
+        addChild(arena.create<GroundTile>(p5, p3, p7));
+        addChild(arena.create<GroundTile>(p7, p6, p5));
+
+        // add obstacles
+        addChild(arena.create<Pillar>(arena, Vec3(4, 0, 3), 0.5, 4));
+        // add obstacles
+        addChild(arena.create<Pillar>(arena, Vec3(4, 0, -3), 0.5, 4));
+
+        
+    }
+
+    Course3::Course3(Game& game) : Course(game, Vec3(4, 1.8, 0), Vec3(-3, 0.5, -1.5)) {
+        // set hole radius
+        holeRadius = 0.4;
+
+        // par
+        par = 4;
+
+        auto heightFunction = [](double x, double y) {
+            return (sin(x/3) + cos(y/2));
+        };
+
+        auto minHeightFunction = [&](double x, double y) {
+            double height = heightFunction(x, y);
+            double minHeight = 0;
+            if (height < minHeight) {
+                return minHeight;
+            }
+            return height;
+        };
+
+        addChild(arena.create<GroundHeightfield>(-5, -5, 5, 5, floorResolution, minHeightFunction));
+
+        std::vector<double> xz;
+        for(double i = 0; i < 2*PI; i += PI/16) {
+            xz.push_back(5 * cos(i));
+            xz.push_back(5 * sin(i));
+        }
+
+        auto walls = buildWallsOnGround(xz, 1, minHeightFunction);
+        for (Wall* wall : walls) {
+            addChild(wall);
+        }
+
+        
+    }
+
+    Course4::Course4(Game& game) : Course(game, Vec3(2, 0, 3), Vec3(-3.5, 0.5, -1)) {
+        // set hole radius
+        holeRadius = 0.4;
+
+        // par
+        par = 4;
+
+        auto heightFunction = [](double x, double y) {
+            double start = -2;
+            double end = 0;
+            double height = 0;
+            if (x > start && x < end) {
+                x -= start;
+                x *= PI/2;
+                height = sin(x)*0.5;
+            }
+            return height;
+        };
+
+        
+
+        addChild(arena.create<GroundHeightfield>(-5, -5, 5, 5, floorResolution, heightFunction));
+        std::vector<double> xz = {-4, -2, -4, 0, 1, 0, 1, 0, 1, 4, 3, 4, 3, 0, 1, -2};
+
+        auto walls = buildWallsOnGround(xz, 1, heightFunction);
+        for (Wall* wall : walls) {
+            addChild(wall);
+        }
+
+        // add obstacles
+        obstacle = arena.create<Pillar>(arena, Vec3(1, 0, 2), 0.5, 4);
+        addMovingChild(obstacle);
+
+        
+    }
+
+    void Course4::tick(unsigned long long time) {
+        Course::tick(time);
+        auto p = this->obstacle->getPosition();
+        p.z = sin(time/(1000.0*1000.0*1000.0))*2;
+        this->obstacle->setPosition(p);
+        updateIndex(this->obstacle);
+    }
+
+    void Controller::draw(Renderer& renderer) {
+        // draw arrow to indicate shot direction and power
+        Vec3 ballPosition, arrowEnd;
+        if(!getArrow(ballPosition, arrowEnd)) return;
+        drawArrow(renderer, ballPosition, arrowEnd);
+
+    }
+
+    void Controller::drawArrow(Renderer& renderer, const Vec3& from, const Vec3& to) {
+        renderer.drawLine(from, to, Vec3(0.2, 0.1, 1), 5);
+    }
+
+    bool Controller::getArrow(Vec3& from, Vec3& to) {
+        if(game.getShotState() != ShotState::AIMING) return false;
+        if(game.getCurrentPlayer() < 0) return false;
+
+        Player& player = game.getPlayers()[game.getCurrentPlayer()];
+        if(!player.isInGame()) return false;
+        if(!mouseHeld) return false;
+
+        Vec3 ballPosition = player.getBall().getPosition();
+        Vec3 direction = mouseLast - ballPosition;
+        if(direction.length() > maxLength) {
+            direction = direction.normalized() * maxLength;
+        }
+        from = ballPosition;
+        to = ballPosition + direction;
+        return true;
+    }
+
+    void Controller::holdMouse(Vec3 mousePos) {
+        if(game.getShotState() != ShotState::AIMING) return;
+        if(game.getCurrentPlayer() < 0) return;
+
+        Player& player = game.getPlayers()[game.getCurrentPlayer()];
+
+        if(!mouseHeld) {
+
+            Vec3 ballNoY = player.getBall().getPosition();
+            ballNoY.y = 0;
+            if(mousePos.getDistance(ballNoY) > player.getBall().getRadius()*2) return;
+
+            mouseHeld = true;
+            mouseStart = mousePos;
+        }
+        mouseLast = mousePos;
+    }
+
+    void Controller::releaseMouse() {
+        if(game.getShotState() != ShotState::AIMING) return;
+        if(!mouseHeld) return;
+        mouseReleased = true;
+    }
+
+    void Controller::tick(unsigned long long time) {
+        if(game.getShotState() != ShotState::AIMING) return;
+        if(game.getCurrentPlayer() < 0) return;
+
+        Player& player = game.getPlayers()[game.getCurrentPlayer()];
+
+        if(this->mouseReleased) {
+            // shoot ball
+            Vec3 ballPosition = player.getBall().getPosition();
+            Vec3 direction = mouseLast - ballPosition;
+            if(direction.length() > maxLength) {
+                direction = direction.normalized() * maxLength;
+            }
+            game.shootBall(direction);
+            std::cout << "Shooting!" << std::endl;
+
+            this->mouseReleased = false;
+            this->mouseHeld = false;
+        }
+
+    }
+
+
+    Game::Game() : controller(*this) {
+        // create a player
+        Player player("Player 1");
+        // add player to game
+        player.getBall().setPosition(Vec3(1, 1, 1));
+        players.push_back(player);
+
+        
+        Player player2("Player 2");
+        player2.getBall().setPosition(Vec3(2, 1, 4));
+        players.push_back(player2);
+        
+
+        // create course
+        //course = new CourseA8(*this);
+
+        startGame();
+
+
+    }
+
+    bool Game::collide(Sphere& sphere) {
+        return this->course->collide(sphere);
+    }
+
+    void Game::draw(Renderer& renderer) {
+
+        // draw course
+        if (course != nullptr)
+            course->draw(renderer);
+
+        // draw balls
+        for (Player& player : players) {
+            if (!player.isInGame()) continue;
+            player.getBall().draw(renderer);
+        }
+
+        // draw controller
+        controller.draw(renderer);
+
+    }
+
+    void Game::fillSnapshot(RenderSnapshot& snapshot) {
+        snapshot.course = course;
+        if (course != nullptr)
+            course->getMovingTransforms(snapshot.movingTransforms);
+        else
+            snapshot.movingTransforms.clear();
+
+        snapshot.balls.clear();
+        for (Player& player : players) {
+            if (player.isInGame())
+                snapshot.balls.push_back(player.getBall());
+        }
+
+        snapshot.showArrow = controller.getArrow(snapshot.arrowFrom, snapshot.arrowTo);
+        snapshot.tick = tickIndex;
+    }
+
+    void Game::applyInput(const GameInput& input) {
+        switch (input.type) {
+        case GameInput::Type::HOLD_MOUSE:
+            controller.holdMouse(input.position);
+            break;
+        case GameInput::Type::RELEASE_MOUSE:
+            controller.releaseMouse();
+            break;
+        case GameInput::Type::SET_GRAVITY:
+            setGravityDirection(input.value);
+            break;
+        case GameInput::Type::SET_DETERMINISTIC:
+            setDeterministic(input.value != 0);
+            break;
+        }
+    }
+
+    void RenderSnapshot::draw(Renderer& renderer) {
+        if (course != nullptr)
+            course->draw(renderer, movingTransforms);
+
+        for (Golfball& ball : balls)
+            ball.draw(renderer);
+
+        if (showArrow)
+            Controller::drawArrow(renderer, arrowFrom, arrowTo);
+    }
+
+    void Game::startGame() {
+        std::cout << "Starting game" << std::endl;
+        nextLevel();
+    }
+
+    bool Game::nextLevel() {
+
+        currentLevel++;
+
+        switch (currentLevel)
+        {
+        case 0:
+            setLevel(new CourseA8(*this));
+            break;
+        case 1:
+            setLevel(new Course2(*this));
+            break;
+        case 2:
+            setLevel(new Course4(*this));
+            break;
+        default:
+            setLevel(nullptr);
+            return false;
+        }
+
+        currentPlayer = -1;
+        shotState = ShotState::READY;
+
+        return true;
+
+    }
+
+    void Game::endGame() {
+        shotState = ShotState::FINISHED;
+
+        // print final scores
+        std::cout << "Final scores:" << std::endl;
+        Player* winner = nullptr;
+        unsigned int lowestScore = UINT_MAX;
+        for (Player& player : players) {
+            if (player.getScore() < lowestScore) {
+                lowestScore = player.getScore();
+                winner = &player;
+            }
+            std::cout << player.getName() << ": " << player.getScore() << std::endl;
+            player.resetAll();
+        } 
+
+        std::cout << "\nWinner: " << winner->getName() << std::endl << std::endl;
+
+
+
+        currentLevel = -1;
+
+
+    }
+
+    void Game::checkHoleEnding() {
+
+        // check if all players have finished the hole
+        for (Player& player : players) {
+            if (!player.hasFinishedHole()) {
+                return;
+            }
+        }
+
+        
+        // all players have finished the hole
+            
+        // check if there is another hole
+        if (nextLevel()) {
+            return;
+        }
+
+        // no more holes, end game
+        endGame();
+
+        
+
+    }
+
+    void Game::shootBall(Vec3 velocity) {
+        // shoots the ball with the given velocity
+
+        // return if not ready to shoot
+        if(shotState == ShotState::MOVING) return;
+
+        if(currentPlayer < 0) return;
+
+        Player& player = players[currentPlayer];
+        shotStart = player.getBall().getPosition();
+        restDetector.reset(shotStart);
+        shotState = ShotState::MOVING;
+        player.getBall().setVelocity(velocity);
+        player.getBall().wake();
+        player.addStroke();
+        shotLog.push_back({tickIndex, velocity});
+
+    }
+
+    void Game::getNextPlayer() {
+        // find the next turn player
+
+        // find a player that hasnt started the hole yet
+        for(size_t i = 0; i < players.size(); i++) {
+            if(!players[i].hasStartedHole()) {
+                currentPlayer = i;
+                players[i].startHole();
+                shotStart = players[i].getBall().getPosition();
+                shotState = ShotState::AIMING;
+                return;
+            }
+        }
+
+        // if all players have started the hole, find the player with most distance to the hole
+        bool foundPlayer = false;
+        double maxDistance = 0;
+        for(size_t i = 0; i < players.size(); i++) {
+            if(!players[i].isInGame()) continue;
+            double distance = players[i].getBall().getPosition().getDistance(course->getHolePosition());
+            if(distance > maxDistance) {
+                maxDistance = distance;
+                currentPlayer = i;
+                foundPlayer = true;
+            }
+        }
+        if(!foundPlayer) {
+            // no player is in game...
+            return;
+        }
+        shotStart = players[currentPlayer].getBall().getPosition();
+        shotState = ShotState::AIMING;
+        
+    }
+
+    void Game::setLevel(Course* course) {
+        // snapshots may still hold the old course, it is deleted with the last of them
+        this->course.reset(course);
+        if(course != nullptr) course->buildIndex(spatialIndexType, collisionPrecision);
+        shotState = ShotState::READY;
+    }
+
+    void Game::tick(unsigned long long time) {
+
+        checkHoleEnding();
+
+        /*
+        switch(shotState) {
+            case ShotState::READY:
+                std::cout << "Ready" << std::endl;
+                break;
+            case ShotState::AIMING:
+                std::cout << "Aiming" << std::endl;
+                break;
+            case ShotState::MOVING: 
+                std::cout << "Moving" << std::endl;
+                break;
+            case ShotState::FINISHED:   
+                std::cout << "Finished" << std::endl;
+                break;
+        }
+        */
+        // ...
+        // check if ball is out of bounds
+        if(currentPlayer >= 0)
+            if(Course::isOutOfBounds(players[currentPlayer].getBall()) && players[currentPlayer].isInGame()) {
+                // out of bounds
+                players[currentPlayer].getBall().setPosition(course->getStartPosition());
+                players[currentPlayer].getBall().setVelocity(Vec3(0));
+                players[currentPlayer].getBall().wake();
+                shotState = ShotState::AIMING;
+                // give penalty
+                players[currentPlayer].addStroke();
+                std::cout << players[currentPlayer].getName() << " is out of bounds!" << std::endl;
+            }
+
+        switch (shotState)
+        {
+        case ShotState::READY:
+            // find next player
+            getNextPlayer();
+            break;
+        case ShotState::AIMING:
+            if(players[currentPlayer].hasFinishedHole()) {
+                    shotState = ShotState::READY;
+                    break;
+            }
+            // set to moving since no controller is used
+            //shotState = ShotState::MOVING;
+            // aim the shot
+            // wait for shot from controller
+            break;
+        case ShotState::MOVING:
+            // check if ball is in hole
+            if(players[currentPlayer].hasFinishedHole()) {
+                shotState = ShotState::READY;
+                break;
+            }
+            // check if ball has stopped
+            if(restDetector.update(players[currentPlayer].getBall(), getDownDirection(gravityDirection))) {
+                shotState = ShotState::READY;
+            }
+
+            break;
+        case ShotState::FINISHED:
+            startGame();
+        default:
+            return;
+        }
+
+
+        // tick course
+        if(course != nullptr)
+            course->tick(time);
+
+        // tick controller, or take the next shot of the replay
+        if(shotState == ShotState::AIMING) {
+            if(replaying) {
+                if(nextReplayShot < replayShots.size() && replayShots[nextReplayShot].tick == tickIndex)
+                    shootBall(replayShots[nextReplayShot++].velocity);
+            } else {
+                controller.tick(time);
+            }
+        }
+
+        // tick players
+        for (Player& player : players) {
+            player.getBall().tick(time);
+        }
+
+
+    }
+
+    void Game::update(unsigned long long time, double dt) {
+        if(deterministic) {
+            time = getSimTime();
+            dt = fixedDt;
+        }
+        tick(time);
+        step(dt);
+        tickIndex++;
+    }
+
+    void Game::setReplay(const std::vector<ShotInput>& shots) {
+        replayShots = shots;
+        nextReplayShot = 0;
+        replaying = true;
+    }
+
+    // FNV-1a over the bits of the values
+    static void hashBits(uint64_t& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    uint64_t Game::getStateHash() {
+        uint64_t hash = 14695981039346656037ULL;
+        hashBits(hash, &tickIndex, sizeof(tickIndex));
+        hashBits(hash, &currentLevel, sizeof(currentLevel));
+        hashBits(hash, &currentPlayer, sizeof(currentPlayer));
+        hashBits(hash, &shotState, sizeof(shotState));
+        for (Player& player : players) {
+            Sphere& ball = player.getBall();
+            const double values[6] = {ball.getPosition().x, ball.getPosition().y, ball.getPosition().z,
+                                      ball.getVelocity().x, ball.getVelocity().y, ball.getVelocity().z};
+            hashBits(hash, values, sizeof(values));
+            unsigned int strokes = player.getStrokes();
+            bool finished = player.hasFinishedHole();
+            hashBits(hash, &strokes, sizeof(strokes));
+            hashBits(hash, &finished, sizeof(finished));
+        }
+        return hash;
+    }
+
+    // moves a ball by its velocity for dt seconds, stopping at every contact on the way
+    void Game::sweepBall(Course& course, Sphere& sphere, double dt, const std::vector<Sphere*>& others) {
+        double remaining = dt;
+        for (int i = 0; i < maxSweepSteps && remaining > 0; i++) {
+            Vec3 motion = sphere.getVelocity() * remaining;
+
+            // earliest contact with the course or another ball
+            double t = course.sweep(sphere, motion);
+            Sphere* hitBall = nullptr;
+            for (Sphere* other : others) {
+                if (other == &sphere) continue;
+                double tBall = other->sweep(sphere, motion);
+                if (tBall < t) {
+                    t = tBall;
+                    hitBall = other;
+                }
+            }
+
+            if (t > 1) {
+                sphere.move(motion);
+                return;
+            }
+
+            // move to the contact and resolve it, then continue with the new velocity
+            sphere.move(motion * t);
+            if (hitBall != nullptr) {
+                sphere.bounce(*hitBall);
+            } else {
+                course.collide(sphere);
+            }
+            remaining *= 1 - t;
+        }
+    }
+
+    void Game::applyGravity(Sphere& sphere, double dt, int gravityDirection) {
+        constexpr double G = 6.67408e-11;
+        constexpr double planetMass = 5.972e24;
+        constexpr double planetRadius = 6.371e6;
+
+        // calculate gravity for planet
+        double mass = sphere.getMass();
+        double force = G * planetMass * mass / pow((sphere.getRadius()) + planetRadius, 2);
+        // apply force
+        double vel = force * dt / mass;
+        double radGrav = gravityDirection * PI / 180.0;
+        sphere.getVelocity().y -=cos(radGrav) * vel;
+        sphere.getVelocity().x +=sin(radGrav) * vel;
+    }
+
+    Vec3 Game::getDownDirection(int gravityDirection) {
+        // same direction as applyGravity
+        double radGrav = gravityDirection * PI / 180.0;
+        return Vec3(sin(radGrav), -cos(radGrav), 0);
+    }
+
+    void RestDetector::reset(const Vec3& start) {
+        stillTicks = 0;
+        fallbackCounter = 0;
+        lastPosition = start;
+    }
+
+    bool RestDetector::update(Sphere& ball, const Vec3& down) {
+        bool still = false;
+        if (0.5 * ball.getVelocity().lengthSquared() < settings.energy && ball.isSupported()) {
+            // gravity split into the part the surfaces push against and the part along them,
+            // friction holds the ball if the slope is no steeper than its friction coefficient
+            const Vec3& normal = ball.getFloorNormal();
+            double pressing = -down.dot(normal);
+            double sliding = (down + normal * pressing).length();
+            still = pressing > 0 && sliding <= ball.getSupportFriction() * pressing + 1e-9;
+        }
+        stillTicks = still ? stillTicks + 1 : 0;
+
+        if (lastPosition.getDistance(ball.getPosition()) < settings.fallbackDistance) {
+            fallbackCounter++;
+        } else {
+            fallbackCounter = 0;
+        }
+        lastPosition = ball.getPosition();
+
+        return stillTicks >= settings.window || fallbackCounter > settings.fallbackTicks;
+    }
+
+    void Game::moveBall(Course* course, Sphere& sphere, double dt, const std::vector<Sphere*>& others) {
+        auto movement = sphere.getVelocity() * dt;
+        if (course != nullptr && movement.length() > sphere.getRadius() * sweepThreshold) {
+            sweepBall(*course, sphere, dt, others);
+            return;
+        }
+        sphere.move(movement);
+    }
+
+    template <typename Function>
+    void Game::forEachBall(size_t count, const Function& function) {
+        if (threadPool == nullptr || count < parallelBallCount) {
+            for (size_t i = 0; i < count; i++)
+                function(i);
+            return;
+        }
+        threadPool->parallelFor(count, ballGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                function(i);
+        });
+    }
+
+    // finds the balls whose bounds over the whole step overlap
+    void Game::findBallNeighbours(double dt) {
+        ballBounds.clear();
+        for (Sphere* sphere : activeBalls)
+        {
+            AABB bounds = sphere->getBounds();
+            if (!sphere->isSleeping()) {
+                Vec3 motion = sphere->getVelocity() * dt;
+                bounds.expand(AABB(bounds.min + motion, bounds.max + motion));
+            }
+            ballBounds.push_back(bounds);
+        }
+        ballPairs.clear();
+        ballBroadphase.findPairs(ballBounds, ballPairs);
+
+        // pairs to lists per ball, in the order of activeBalls
+        neighbourStart.assign(activeBalls.size() + 1, 0);
+        for (const auto& pair : ballPairs)
+        {
+            neighbourStart[pair.first + 1]++;
+            neighbourStart[pair.second + 1]++;
+        }
+        for (size_t i = 0; i < activeBalls.size(); i++)
+            neighbourStart[i + 1] += neighbourStart[i];
+        neighbours.resize(neighbourStart.back());
+        neighbourFill.assign(neighbourStart.begin(), neighbourStart.end() - 1);
+        // the pairs are sorted, so every list ends up sorted:
+        // first the lower neighbours of each ball, then the higher ones
+        for (const auto& pair : ballPairs)
+        {
+            neighbours[neighbourFill[pair.second]++] = activeBalls[pair.first];
+        }
+        for (const auto& pair : ballPairs)
+        {
+            neighbours[neighbourFill[pair.first]++] = activeBalls[pair.second];
+        }
+    }
+
+    // advances the physics of all balls in game by dt seconds
+    // gravity, movement and collisions with the course and other balls
+    void Game::step(double dt) {
+        activeBalls.clear();
+        for (Player& player : players)
+        {
+            if(player.isInGame()) activeBalls.push_back(&player.getBall());
+        }
+
+        // wake balls that a moving part of the course may have hit
+        if (course != nullptr) {
+            if (!course->getMovedArea().isEmpty()) {
+                for (Sphere* sphere : activeBalls)
+                {
+                    if (sphere->isSleeping() && course->getMovedArea().overlaps(sphere->getBounds()))
+                        sphere->wake();
+                }
+            }
+            course->clearMovedArea();
+        }
+
+        // apply gravity, sleeping balls are skipped until they are woken
+        forEachBall(activeBalls.size(), [&](size_t i) {
+            if (!activeBalls[i]->isSleeping())
+                applyGravity(*activeBalls[i], dt, gravityDirection);
+        });
+
+        // apply velocity and check collisions with golf objects
+        // fast balls are swept so they cannot pass through walls or the floor, or other balls on the way
+        // balls that cannot reach another ball in this step only change themselves, so they are done in parallel
+        // the others move one after the other, in the same order on every run
+        findBallNeighbours(dt);
+        isolatedBalls.clear();
+        connectedBalls.clear();
+        for (size_t i = 0; i < activeBalls.size(); i++)
+        {
+            if (activeBalls[i]->isSleeping()) continue;
+            if (neighbourStart[i] == neighbourStart[i + 1])
+                isolatedBalls.push_back(i);
+            else
+                connectedBalls.push_back(i);
+        }
+
+        static const std::vector<Sphere*> noOtherBalls;
+        forEachBall(isolatedBalls.size(), [&](size_t i) {
+            Sphere& sphere = *activeBalls[isolatedBalls[i]];
+            moveBall(course.get(), sphere, dt, noOtherBalls);
+            if (course != nullptr)
+                collide(sphere);
+        });
+        for (size_t i : connectedBalls)
+        {
+            sweepCandidates.assign(neighbours.begin() + neighbourStart[i], neighbours.begin() + neighbourStart[i + 1]);
+            moveBall(course.get(), *activeBalls[i], dt, sweepCandidates);
+        }
+
+        if (course == nullptr)
+            return;
+
+        forEachBall(connectedBalls.size(), [&](size_t i) {
+            collide(*activeBalls[connectedBalls[i]]);
+        });
+
+        // check collisions between balls, only pairs whose bounds overlap are tested
+        ballBounds.clear();
+        for (Sphere* sphere : activeBalls)
+        {
+            ballBounds.push_back(sphere->getBounds());
+        }
+        ballPairs.clear();
+        ballBroadphase.findPairs(ballBounds, ballPairs);
+        for (const auto& pair : ballPairs)
+        {
+            Sphere& sphere = *activeBalls[pair.first];
+            Sphere& other = *activeBalls[pair.second];
+
+            // continue if both are at rest
+            if (sphere.isSleeping() && other.isSleeping())
+                continue;
+            // earlier bounces may have moved them apart
+            if (sphere.getPosition().getDistance(other.getPosition()) < sphere.getRadius() + other.getRadius())
+                sphere.bounce(other);
+        }
+
+        for (Sphere* sphere : activeBalls)
+        {
+            sphere->updateSleep();
+        }
+    }
+
+}
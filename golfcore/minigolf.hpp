@@ -0,0 +1,447 @@
+
+#ifndef MINIGOLF_HPP
+#define MINIGOLF_HPP
+
+#include <vector>
+#include "simulation.hpp"
+#include "spatialindex.hpp"
+#include "collisionstore.hpp"
+#include "threadpool.hpp"
+#include "arena.hpp"
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+
+namespace golf
+{
+
+    enum class ShotState
+    {
+        READY,
+        AIMING,
+        MOVING,
+        FINISHED
+    };
+
+    const std::string getScoreTerm(int score, int par);
+
+    class GroundTile : public Triangle
+    {
+    public:
+        GroundTile(const Vec3 &p1, const Vec3 &p2, const Vec3 &p3) : Triangle(p1, p2, p3)
+        {
+            this->frictionCoefficient = 0.03;
+            this->faceCollisionOnly = true;
+            this->bounceFactor = 0.8;
+            this->color = Vec3(0.5, 0.7, 0.1);
+        }
+    };
+
+    // ground tiles merged by Course::mergeGroundTiles, plays like them
+    class GroundPolygon : public ConvexPolygon
+    {
+    public:
+        GroundPolygon(const std::vector<Vec3> &corners) : ConvexPolygon(corners)
+        {
+            this->frictionCoefficient = 0.03;
+            this->bounceFactor = 0.8;
+            this->color = Vec3(0.5, 0.7, 0.1);
+        }
+    };
+
+    // ground of a terrain course, plays like the ground tiles
+    class GroundHeightfield : public Heightfield
+    {
+    public:
+        GroundHeightfield(double minX, double minZ, double maxX, double maxZ, double resolution, const std::function<double(double, double)> &heightFunction)
+            : Heightfield(minX, minZ, maxX, maxZ, resolution, heightFunction)
+        {
+            this->frictionCoefficient = 0.03;
+            this->bounceFactor = 0.8;
+            this->color = Vec3(0.5, 0.7, 0.1);
+        }
+    };
+
+    class Golfball : public Sphere
+    {
+    public:
+        Golfball() : Sphere(Vec3(0), 0.4) { this->bounceFactor = 1.0; }
+    };
+
+    class Player
+    {
+
+    private:
+        std::string name;
+        unsigned int score = 0;
+        unsigned int strokes = 0;
+        bool finishedHole = false;
+        bool startedHole = false;
+        Golfball ball;
+
+    public:
+        Player(const std::string &name);
+
+        std::string getName() { return name; }
+        unsigned int getScore() { return score; }
+        void setScore(unsigned int score) { this->score = score; }
+        Golfball &getBall() { return ball; }
+        void setBall(Golfball ball) { this->ball = ball; }
+        bool hasFinishedHole() { return finishedHole; }
+        void reset(Vec3 position);
+        void resetAll();
+        void setFinishedHole(bool finishedHole) { this->finishedHole = finishedHole; }
+        unsigned int getStrokes() { return strokes; }
+        void addStroke() { strokes++; }
+        bool isInGame() { return startedHole && !finishedHole; }
+        bool hasStartedHole() { return startedHole; }
+        void startHole();
+        void setStartedHole(bool startedHole) { this->startedHole = startedHole; }
+    };
+    // a shot as the game applied it, enough to replay a deterministic game
+    struct ShotInput
+    {
+        unsigned long long tick;
+        Vec3 velocity;
+    };
+
+    // local transform of an object at one point in time
+    struct ObjectTransform
+    {
+        Vec3 position;
+    };
+
+    class Game;
+    // a base golf course with walls, floor, obstacles and a hole
+    class Course : public SimObject
+    {
+    protected:
+        // owns all objects of the course, released in one go with the course
+        // declared first so it outlives every member that points into it
+        Arena arena;
+        Vec3 holePosition;
+        double holeRadius;
+        Vec3 startPosition;
+        Game &game;
+        unsigned int par = 3;
+        // finds the static children near a ball, nullptr until buildIndex is called
+        // built once, the moving children are not in it
+        std::unique_ptr<SpatialIndex> index;
+        // child of every id in index, ascending
+        std::vector<size_t> staticChildIds;
+        // child and current bounds of every moving child, refit by updateIndex
+        std::vector<size_t> movingChildIds;
+        std::vector<AABB> movingBounds;
+        // most ids queryChildren can return, the collision buffers are reserved to this
+        size_t maxNearby = 0;
+        // triangle children, tested together before calling their findContacts
+        // only the store matching collisionPrecision is filled
+        TriangleStore triangleStore;
+        FloatTriangleStore floatTriangleStore;
+        CollisionPrecision collisionPrecision = CollisionPrecision::DOUBLE;
+        // slot in triangleStore of every child, SIZE_MAX if it is not a static triangle
+        std::vector<size_t> storeSlots;
+        // bounds of the children moved by updateIndex since the last clearMovedArea
+        AABB movedArea;
+        // children that move during the game, all other children keep their transform after construction
+        std::vector<SimObject*> movingChildren;
+        // unique for every course ever built, renderers keep the static geometry under it
+        unsigned long long id;
+
+        // adds a child that is moved in tick, only its children are drawn (see drawChildrenAt)
+        void addMovingChild(SimObject *child);
+        // appends the children whose bounds overlap area, sorted like children
+        void queryChildren(const AABB &area, std::vector<size_t> &result) const;
+        // replaces static ground tiles that lie in one plane and share an edge by convex polygons
+        // corners closer than weldDistance are treated as one, so the edges between the tiles disappear
+        void mergeGroundTiles();
+
+    public:
+        Course(Game &game, Vec3 holePosition, Vec3 startPosition);
+        void draw(Renderer &renderer);
+        // draws the moving children at the given transforms instead of their current ones
+        // reads nothing that tick changes, so it can run on another thread than the game
+        // the other children are drawn through Renderer::drawStatic with the id of the course
+        void draw(Renderer &renderer, const std::vector<ObjectTransform> &movingTransforms);
+        unsigned long long getId() { return id; }
+        // current transforms of the moving children, in the order draw expects them
+        void getMovingTransforms(std::vector<ObjectTransform> &transforms);
+        const Vec3 &getHolePosition() { return holePosition; }
+        double getHoleRadius() { return holeRadius; }
+        const Vec3 &getStartPosition() { return startPosition; }
+        // collide and sweep do not change the course, so several threads can use them at once
+        void findContacts(Sphere &sphere, ContactManifold &manifold);
+        double sweep(Sphere &sphere, const Vec3 &motion);
+        virtual void tick(unsigned long long time);
+        void checkHole();
+        // balls below this height are out of bounds
+        static constexpr double outOfBoundsHeight = -10;
+        // corners of ground tiles closer than this are welded into one by mergeGroundTiles
+        static constexpr double weldDistance = 1e-6;
+        // cell size of the heightfield floors of terrain courses
+        static constexpr double floorResolution = 0.05;
+        bool isInHole(Sphere &ball) { return ball.getPosition().getDistance(holePosition) < holeRadius + ball.getRadius(); }
+        static bool isOutOfBounds(Sphere &ball) { return ball.getPosition().y < outOfBoundsHeight; }
+        // merges the ground tiles, then builds the spatial index and triangle store over the static children
+        // the store only gets the triangles left after merging, the shipped courses have none,
+        // their floors become polygons or heightfields and only custom triangle geometry goes through it
+        // call after the course is complete
+        // both precisions give the same results, FLOAT tests more triangles per instruction
+        void buildIndex(SpatialIndexType type, CollisionPrecision precision = CollisionPrecision::DOUBLE);
+        // call after moving a child added with addMovingChild to refit its bounds, the other children must not move
+        void updateIndex(SimObject *child);
+        // sleeping balls in this area are woken, they may have been hit by a moving child
+        const AABB &getMovedArea() { return movedArea; }
+        void clearMovedArea() { movedArea = AABB(); }
+        // the build functions allocate in the course arena
+        Wall* buildWallOnGround(double x1, double z1, double x2, double z2, double height, std::function<double(double, double)> heightFunction);
+        std::vector<Wall*> buildWallsOnGround(const std::vector<double>& xz, double height, std::function<double(double, double)> heightFunction);
+    };
+
+    class CourseA8 : public Course
+    {
+    public:
+        CourseA8(Game &game);
+    };
+
+    class Course2 : public Course
+    {
+    public:
+        Course2(Game &game);
+    };
+
+    class Course3 : public Course
+    {
+    public:
+        Course3(Game &game);
+    };
+
+    class Course4 : public Course
+    {
+    private:
+        SimObject* obstacle;
+    public:
+        Course4(Game &game);
+        void tick(unsigned long long time);
+    };
+
+    // a controller for storing, changing and displaying golf shots
+    class Controller : public SimObject
+    {
+
+    private:
+        double maxLength = 3;
+        double direction = 0;
+        Game& game;
+        Vec3 mouseStart;
+        bool mouseHeld = false;
+        Vec3 mouseLast;
+        bool mouseReleased = false;
+
+    public:
+        Controller(Game& game) : game(game) {}
+        void draw(Renderer &renderer);
+        void tick(unsigned long long time);
+        void holdMouse(Vec3 mousePos);
+        void releaseMouse();
+        // start and end of the shot arrow, false if no shot is being aimed
+        bool getArrow(Vec3 &from, Vec3 &to);
+        static void drawArrow(Renderer &renderer, const Vec3 &from, const Vec3 &to);
+
+    };
+
+    // input from the ui thread, applied by the game thread with Game::applyInput
+    struct GameInput
+    {
+        enum class Type
+        {
+            HOLD_MOUSE,
+            RELEASE_MOUSE,
+            SET_GRAVITY,
+            SET_DETERMINISTIC
+        };
+        Type type;
+        // mouse position in world space for HOLD_MOUSE
+        Vec3 position;
+        // gravity direction in degrees or deterministic flag
+        int value = 0;
+    };
+
+    // what the renderer needs of one game tick
+    // filled by the game thread, then drawn by the render thread while the game goes on
+    struct RenderSnapshot
+    {
+        // keeps the course alive while it is drawn, even if the game loaded the next one
+        std::shared_ptr<Course> course;
+        std::vector<ObjectTransform> movingTransforms;
+        // copies of the balls in game
+        std::vector<Golfball> balls;
+        bool showArrow = false;
+        Vec3 arrowFrom;
+        Vec3 arrowTo;
+        unsigned long long tick = 0;
+
+        void draw(Renderer &renderer);
+    };
+
+    struct RestSettings
+    {
+        // kinetic energy per unit of mass below which a ball counts as still, the energy of a ball at 0.01 units/s
+        double energy = 0.5 * 0.01 * 0.01;
+        // ticks in a row a ball has to be still, and held by the surfaces it touches, before it is at rest
+        unsigned int window = 10;
+        // a ball that keeps moving without getting anywhere is at rest after fallbackTicks ticks in a row
+        // in which it moved less than fallbackDistance, e.g. when it is stuck between obstacles
+        double fallbackDistance = 0.01;
+        unsigned int fallbackTicks = 120;
+    };
+
+    // Decides when a moving ball has come to rest, for Game::tick and the ShotEvaluator
+    // a ball is still when it is slow, surfaces push it against gravity,
+    // and the slope under it is flat enough for their friction to hold it
+    class RestDetector
+    {
+    private:
+        RestSettings settings;
+        unsigned int stillTicks = 0;
+        unsigned int fallbackCounter = 0;
+        Vec3 lastPosition;
+
+    public:
+        RestDetector(const RestSettings &settings = RestSettings()) : settings(settings) {}
+        void setSettings(const RestSettings &settings) { this->settings = settings; }
+        const RestSettings &getSettings() { return settings; }
+        // call when the ball is shot from start
+        void reset(const Vec3 &start);
+        // call once per tick after the ball was collided, true once it is at rest
+        // down is the direction of gravity, see Game::getDownDirection
+        bool update(Sphere &ball, const Vec3 &down);
+    };
+
+    // the top class controlling other parts like course, controller, ...
+    class Game : public SimObject
+    {
+
+    private:
+        Controller controller;
+        // shared with the render snapshots that still draw it
+        std::shared_ptr<Course> course;
+        std::vector<Player> players;
+        int currentPlayer = 0;
+        ShotState shotState = ShotState::READY;
+        RestDetector restDetector;
+        Vec3 shotStart;
+        unsigned int currentLevel = -1;
+        SpatialIndexType spatialIndexType = SpatialIndexType::GRID;
+        CollisionPrecision collisionPrecision = CollisionPrecision::DOUBLE;
+
+        // balls in game during step()
+        std::vector<Sphere*> activeBalls;
+        // ball against ball broadphase, kept between steps to reuse its memory
+        SpatialHash ballBroadphase;
+        std::vector<AABB> ballBounds;
+        std::vector<std::pair<size_t, size_t>> ballPairs;
+        // balls a ball can hit during the movement of a step, neighbours[neighbourStart[i]] ... of activeBalls[i]
+        std::vector<size_t> neighbourStart;
+        std::vector<size_t> neighbourFill;
+        std::vector<Sphere*> neighbours;
+        std::vector<Sphere*> sweepCandidates;
+        // indices into activeBalls of the awake balls without and with neighbours
+        std::vector<size_t> isolatedBalls;
+        std::vector<size_t> connectedBalls;
+        ThreadPool *threadPool = nullptr;
+
+        void findBallNeighbours(double dt);
+        // calls function(i) for i in [0, count), on the thread pool if there is one and there are enough balls
+        // a template so the lambdas of step() are not copied into a std::function, which can allocate
+        template <typename Function>
+        void forEachBall(size_t count, const Function &function);
+
+        static void sweepBall(Course &course, Sphere &sphere, double dt, const std::vector<Sphere*> &others);
+        // direction of gravity in degrees, 0 is straight down
+        int gravityDirection = 0;
+
+        // deterministic mode, see update()
+        bool deterministic = false;
+        unsigned long long tickIndex = 0;
+        std::vector<ShotInput> shotLog;
+        std::vector<ShotInput> replayShots;
+        size_t nextReplayShot = 0;
+        bool replaying = false;
+
+    public:
+        // balls moving more than this fraction of their radius in one step are swept
+        static constexpr double sweepThreshold = 0.5;
+        // maximum number of contacts a swept ball handles in one step
+        static constexpr int maxSweepSteps = 8;
+        // length of one update in deterministic mode
+        static constexpr double fixedDt = 1.0 / 60;
+        static constexpr unsigned long long fixedTickNanos = 16666667;
+        // with a thread pool, balls are processed in parallel from this many balls on, in ranges of ballGrain balls
+        static constexpr size_t parallelBallCount = 64;
+        static constexpr size_t ballGrain = 16;
+
+        // physics of a single ball, used by step() and the ShotEvaluator
+        static void applyGravity(Sphere &sphere, double dt, int gravityDirection);
+        // unit vector gravity pulls along
+        static Vec3 getDownDirection(int gravityDirection);
+        // moves the ball by its velocity, fast balls are swept against the course and the other balls
+        static void moveBall(Course *course, Sphere &sphere, double dt, const std::vector<Sphere*> &others);
+
+        Game();
+
+        std::vector<Player> &getPlayers() { return players; }
+        Controller &getController() { return controller; }
+        Course &getCourse() { return *course; }
+        void draw(Renderer &renderer);
+        // copies the drawable state into snapshot, reusing its memory
+        void fillSnapshot(RenderSnapshot &snapshot);
+        void applyInput(const GameInput &input);
+        bool collide(Sphere &sphere);
+        void tick(unsigned long long time);
+        void step(double dt);
+        // one tick and one physics step, time in nanoseconds and dt in seconds
+        // in deterministic mode both are ignored: the clock is getSimTime() and every step is fixedDt long,
+        // so the same shots at the same ticks give bit identical games
+        void update(unsigned long long time, double dt);
+        void setDeterministic(bool deterministic) { this->deterministic = deterministic; }
+        bool isDeterministic() { return deterministic; }
+        // number of update() calls so far
+        unsigned long long getTickIndex() { return tickIndex; }
+        unsigned long long getSimTime() { return tickIndex * fixedTickNanos; }
+        // every shot so far with the tick it was applied in
+        const std::vector<ShotInput> &getShotLog() { return shotLog; }
+        // applies these shots at their ticks instead of the controller's, for a game started at tick 0
+        void setReplay(const std::vector<ShotInput> &shots);
+        bool isReplaying() { return replaying; }
+        // hash over the exact bits of the game state, equal at equal ticks if two runs are identical
+        uint64_t getStateHash();
+        void setGravityDirection(int degrees) { gravityDirection = degrees; }
+        // pool used by step() for the balls, nullptr runs everything on the calling thread
+        // the results are the same with and without a pool, the pool can be shared with other games
+        void setThreadPool(ThreadPool *pool) { threadPool = pool; }
+        // index used for courses loaded after this call
+        void setSpatialIndexType(SpatialIndexType type) { spatialIndexType = type; }
+        SpatialIndexType getSpatialIndexType() { return spatialIndexType; }
+        // triangle store precision used for courses loaded after this call
+        void setCollisionPrecision(CollisionPrecision precision) { collisionPrecision = precision; }
+        CollisionPrecision getCollisionPrecision() { return collisionPrecision; }
+        int getGravityDirection() { return gravityDirection; }
+        // when the ball of a shot counts as at rest, so the next player can shoot
+        void setRestSettings(const RestSettings &settings) { restDetector.setSettings(settings); }
+        void checkHoleEnding();
+        void startGame();
+        bool nextLevel();
+        void endGame();
+        void getNextPlayer();
+        void shootBall(Vec3 velocity);
+        void setLevel(Course* course);
+        int getCurrentPlayer() { return currentPlayer; }
+        ShotState getShotState() { return shotState; }
+    };
+
+};
+
+#endif // MINIGOLF_HPP
@@ -0,0 +1,188 @@
+#include "obstacles.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace golf {
+
+    // surfaces facing up at least this much are rolled on like the ground, steeper ones bounce the ball
+    static constexpr double groundNormalY = 0.7;
+    // the sweep stops this close to the contact
+    static constexpr double sweepTolerance = 1e-6;
+    static constexpr int maxSweepSteps = 32;
+
+    void Collider::findContacts(Sphere& sphere, ContactManifold& manifold) {
+        auto center = sphere.getWorldPosition() - getWorldPosition();
+        auto radius = sphere.getRadius();
+        Vec3 normal;
+        double dist = getSurfaceDistance(center, normal);
+        if (dist > radius) return;
+
+        // the ball rolls over surfaces facing up and bounces off the others
+        if (normal.y > groundNormalY) {
+            manifold.add({normal, radius - dist + 0.001, 0, frictionCoefficient});
+        } else {
+            manifold.add({normal, radius - dist + 0.001, sphere.calcBounceFactor(*this), 0});
+        }
+    }
+
+    double Collider::sweep(Sphere& sphere, const Vec3& motion) {
+        double length = motion.length();
+        if (length == 0.0) return INFINITY;
+
+        auto start = sphere.getWorldPosition() - getWorldPosition();
+        double sweepRadius = sphere.getRadius() - SWEEP_SLOP;
+        Vec3 normal;
+
+        // touching already, stop only if moving further in
+        double gap = getSurfaceDistance(start, normal) - sweepRadius;
+        if (gap <= 0) return motion.dot(normal) < 0 ? 0 : INFINITY;
+
+        // advance by the free distance around the sphere each time, it cannot pass the surface on the way
+        double t = 0;
+        for (int i = 0; i < maxSweepSteps && gap > sweepTolerance; i++) {
+            t += gap / length;
+            if (t > 1) return INFINITY;
+            gap = getSurfaceDistance(start + motion * t, normal) - sweepRadius;
+        }
+        return t;
+    }
+
+    double Cylinder::getSurfaceDistance(const Vec3& point, Vec3& normal) {
+        // distance outside of the side and outside of the caps, negative inside
+        double distance = std::sqrt(point.x * point.x + point.z * point.z);
+        Vec3 outward = distance > 0 ? Vec3(point.x / distance, 0, point.z / distance) : Vec3(1, 0, 0);
+        double side = distance - radius;
+        double cap = std::max(-point.y, point.y - height);
+        Vec3 up(0, point.y > height / 2 ? 1 : -1, 0);
+
+        if (side > 0 && cap > 0) {
+            // closest to the rim
+            double rim = std::sqrt(side * side + cap * cap);
+            normal = (outward * side + up * cap) / rim;
+            return rim;
+        }
+        if (side > cap) {
+            normal = outward;
+            return side;
+        }
+        normal = up;
+        return cap;
+    }
+
+    AABB Cylinder::getBounds() {
+        auto worldPos = getWorldPosition();
+        return AABB(worldPos + Vec3(-radius, 0, -radius), worldPos + Vec3(radius, height, radius));
+    }
+
+    void Cylinder::addMesh(Arena& arena, int resolution) {
+        SimObject* top = arena.create<SimObject>();
+        SimObject* bottom = arena.create<SimObject>();
+        SimObject* sides = arena.create<SimObject>();
+        Vec3 center(0);
+        for(int i = 0; i < resolution; i++) {
+            double angle = 2 * PI * i / resolution;
+            Vec3 p1(radius * cos(angle), 0, radius * sin(angle));
+            Vec3 p2(radius * cos(angle + 2 * PI / resolution), 0, radius * sin(angle + 2 * PI / resolution));
+            top->addChild(arena.create<Triangle>(center, p1, p2));
+            bottom->addChild(arena.create<Triangle>(center, p1, p2));
+
+            // sides
+            Vec3 p3(radius * cos(angle), height, radius * sin(angle));
+            Vec3 p4(radius * cos(angle + 2 * PI / resolution), height, radius * sin(angle + 2 * PI / resolution));
+            sides->addChild(arena.create<Triangle>(p1, p2, p3));
+            sides->addChild(arena.create<Triangle>(p2, p3, p4));
+
+        }
+        top->setPosition(Vec3(0, height, 0));
+        addChild(top);
+        addChild(bottom);
+        addChild(sides);
+    }
+
+    double Capsule::getSurfaceDistance(const Vec3& point, Vec3& normal) {
+        // closest point on the segment
+        Vec3 axis = end - start;
+        double t = axis.lengthSquared() > 0 ? (point - start).dot(axis) / axis.lengthSquared() : 0;
+        t = std::min(std::max(t, 0.0), 1.0);
+        Vec3 offset = point - (start + axis * t);
+        double distance = offset.length();
+        normal = distance > 0 ? offset / distance : Vec3(0, 1, 0);
+        return distance - radius;
+    }
+
+    AABB Capsule::getBounds() {
+        auto worldPos = getWorldPosition();
+        AABB bounds(worldPos + start - Vec3(radius), worldPos + start + Vec3(radius));
+        bounds.expand(AABB(worldPos + end - Vec3(radius), worldPos + end + Vec3(radius)));
+        return bounds;
+    }
+
+    void Capsule::addMesh(Arena& arena, int resolution) {
+        addChild(arena.create<Sphere>(start, radius, resolution));
+        addChild(arena.create<Sphere>(end, radius, resolution));
+
+        // two vectors orthogonal to the axis span the rings at both ends
+        Vec3 axis = (end - start).normalized();
+        Vec3 other = std::abs(axis.y) < 0.9 ? Vec3(0, 1, 0) : Vec3(1, 0, 0);
+        Vec3 u = axis.cross(other).normalized();
+        Vec3 w = axis.cross(u);
+        SimObject* sides = arena.create<SimObject>();
+        for(int i = 0; i < resolution; i++) {
+            double angle = 2 * PI * i / resolution;
+            double next = 2 * PI * (i + 1) / resolution;
+            Vec3 ring1 = (u * cos(angle) + w * sin(angle)) * radius;
+            Vec3 ring2 = (u * cos(next) + w * sin(next)) * radius;
+            sides->addChild(arena.create<Triangle>(start + ring1, start + ring2, end + ring1));
+            sides->addChild(arena.create<Triangle>(start + ring2, end + ring1, end + ring2));
+        }
+        addChild(sides);
+    }
+
+    double Cuboid::getSurfaceDistance(const Vec3& point, Vec3& normal) {
+        // distance outside of each pair of faces, negative inside
+        Vec3 sign(point.x < 0 ? -1 : 1, point.y < 0 ? -1 : 1, point.z < 0 ? -1 : 1);
+        Vec3 q(std::abs(point.x) - halfSize.x, std::abs(point.y) - halfSize.y, std::abs(point.z) - halfSize.z);
+        Vec3 outside(std::max(q.x, 0.0), std::max(q.y, 0.0), std::max(q.z, 0.0));
+        double distance = outside.length();
+        if (distance > 0) {
+            normal = Vec3(sign.x * outside.x, sign.y * outside.y, sign.z * outside.z) / distance;
+            return distance;
+        }
+
+        // inside, out through the closest face
+        if (q.x >= q.y && q.x >= q.z) {
+            normal = Vec3(sign.x, 0, 0);
+            return q.x;
+        }
+        if (q.y >= q.z) {
+            normal = Vec3(0, sign.y, 0);
+            return q.y;
+        }
+        normal = Vec3(0, 0, sign.z);
+        return q.z;
+    }
+
+    AABB Cuboid::getBounds() {
+        auto worldPos = getWorldPosition();
+        return AABB(worldPos - halfSize, worldPos + halfSize);
+    }
+
+    void Cuboid::addMesh(Arena& arena) {
+        const Vec3& h = halfSize;
+        // corners of the bottom and the top face, counterclockwise seen from above
+        Vec3 b[4] = {Vec3(-h.x, -h.y, -h.z), Vec3(-h.x, -h.y, h.z), Vec3(h.x, -h.y, h.z), Vec3(h.x, -h.y, -h.z)};
+        Vec3 t[4] = {Vec3(-h.x, h.y, -h.z), Vec3(-h.x, h.y, h.z), Vec3(h.x, h.y, h.z), Vec3(h.x, h.y, -h.z)};
+        for(int i = 0; i < 4; i++) {
+            int j = (i + 1) % 4;
+            addChild(arena.create<Wall>(b[i], t[i], t[j], b[j]));
+        }
+        addChild(arena.create<Wall>(b[0], b[1], b[2], b[3]));
+        addChild(arena.create<Wall>(t[0], t[3], t[2], t[1]));
+    }
+
+    Pillar::Pillar(Arena &arena, const Vec3 &position, double radius, double height) : Cylinder(position, radius, height)
+    {
+        addMesh(arena);
+    }
+
+}
@@ -0,0 +1,85 @@
+#ifndef OBSTACLES_HPP
+#define OBSTACLES_HPP
+
+#include "simulation.hpp"
+#include "arena.hpp"
+
+namespace golf
+{
+
+    // A solid obstacle with an exact shape
+    // findContacts and sweep use the shape alone, the children are only drawn,
+    // so they can hold a mesh of it (see addMesh) without being tested by every ball
+    class Collider : public SimObject
+    {
+    protected:
+        // signed distance from a point in local space to the surface, negative inside,
+        // and the outward normal of the closest surface point
+        virtual double getSurfaceDistance(const Vec3 &point, Vec3 &normal) = 0;
+
+    public:
+        Collider(const Vec3 &position) : SimObject(position) {}
+        void findContacts(Sphere &sphere, ContactManifold &manifold);
+        double sweep(Sphere &sphere, const Vec3 &motion);
+        double getMass() { return 99999999999.9; }
+    };
+
+    // An upright cylinder with flat caps, position is the center of the bottom cap
+    class Cylinder : public Collider
+    {
+    protected:
+        double radius;
+        double height;
+
+        double getSurfaceDistance(const Vec3 &point, Vec3 &normal);
+
+    public:
+        Cylinder(const Vec3 &position, double radius, double height) : Collider(position), radius(radius), height(height) {}
+        AABB getBounds();
+        // triangles for drawing, created in arena
+        void addMesh(Arena &arena, int resolution = 10);
+    };
+
+    // A cylinder with half spheres on both ends, around the segment from start to end in local space
+    class Capsule : public Collider
+    {
+    protected:
+        Vec3 start;
+        Vec3 end;
+        double radius;
+
+        double getSurfaceDistance(const Vec3 &point, Vec3 &normal);
+
+    public:
+        Capsule(const Vec3 &position, const Vec3 &start, const Vec3 &end, double radius) : Collider(position), start(start), end(end), radius(radius) {}
+        AABB getBounds();
+        // spheres for the ends and triangles for the side, created in arena
+        void addMesh(Arena &arena, int resolution = 10);
+    };
+
+    // An axis aligned box around position
+    class Cuboid : public Collider
+    {
+    protected:
+        Vec3 halfSize;
+
+        double getSurfaceDistance(const Vec3 &point, Vec3 &normal);
+
+    public:
+        Cuboid(const Vec3 &position, const Vec3 &halfSize) : Collider(position), halfSize(halfSize) {}
+        AABB getBounds();
+        // a wall for every face, created in arena
+        void addMesh(Arena &arena);
+    };
+
+    class Pillar : public Cylinder
+    {
+
+    public:
+        // the mesh is created in arena
+        Pillar(Arena &arena, const Vec3 &position, double radius, double height);
+    };
+
+}
+
+#endif // OBSTACLES_HPP
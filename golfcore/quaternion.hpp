@@ -0,0 +1,69 @@
+#ifndef QUATERNION_HPP
+#define QUATERNION_HPP
+
+#include <cmath>
+#include "vec3.hpp"
+
+// A unit quaternion storing an orientation
+// 32 bytes instead of a 4x4 matrix, combining two rotations is 16 multiplications
+// and renormalizing keeps it a pure rotation over any number of steps
+class Quaternion {
+public:
+    double w, x, y, z;
+    Quaternion() : w(1), x(0), y(0), z(0) {}
+    Quaternion(double w, double x, double y, double z) : w(w), x(x), y(y), z(z) {}
+
+    // rotation by angle radians around the unit vector axis, counterclockwise like glRotate
+    static Quaternion fromAxisAngle(const Vec3& axis, double angle)
+    {
+        double s = std::sin(angle / 2);
+        return Quaternion(std::cos(angle / 2), axis.x * s, axis.y * s, axis.z * s);
+    }
+
+    // rotation by other first, then by this
+    Quaternion operator*(const Quaternion& q) const
+    {
+        return Quaternion(w * q.w - x * q.x - y * q.y - z * q.z,
+                          w * q.x + x * q.w + y * q.z - z * q.y,
+                          w * q.y - x * q.z + y * q.w + z * q.x,
+                          w * q.z + x * q.y - y * q.x + z * q.w);
+    }
+
+    double length() const { return std::sqrt(w * w + x * x + y * y + z * z); }
+    Quaternion normalized() const
+    {
+        double l = length();
+        return Quaternion(w / l, x / l, y / l, z / l);
+    }
+
+    Vec3 rotate(const Vec3& v) const
+    {
+        // v + 2w(u x v) + 2u x (u x v) with u = (x, y, z)
+        Vec3 u(x, y, z);
+        Vec3 t = u.cross(v) * 2.0;
+        return v + t * w + u.cross(t);
+    }
+
+    // column major rotation matrix for glMultMatrixf
+    void toMatrix(float matrix[16]) const
+    {
+        matrix[0] = static_cast<float>(1 - 2 * (y * y + z * z));
+        matrix[1] = static_cast<float>(2 * (x * y + w * z));
+        matrix[2] = static_cast<float>(2 * (x * z - w * y));
+        matrix[3] = 0;
+        matrix[4] = static_cast<float>(2 * (x * y - w * z));
+        matrix[5] = static_cast<float>(1 - 2 * (x * x + z * z));
+        matrix[6] = static_cast<float>(2 * (y * z + w * x));
+        matrix[7] = 0;
+        matrix[8] = static_cast<float>(2 * (x * z + w * y));
+        matrix[9] = static_cast<float>(2 * (y * z - w * x));
+        matrix[10] = static_cast<float>(1 - 2 * (x * x + y * y));
+        matrix[11] = 0;
+        matrix[12] = 0;
+        matrix[13] = 0;
+        matrix[14] = 0;
+        matrix[15] = 1;
+    }
+};
+
+#endif // QUATERNION_HPP
@@ -0,0 +1,44 @@
+#ifndef RENDERER_HPP
+#define RENDERER_HPP
+
+#include <functional>
+
+template <typename T>
+class Vec3T;
+using Vec3 = Vec3T<double>;
+class Triangle;
+class Wall;
+class ConvexPolygon;
+class Sphere;
+class Box;
+class Heightfield;
+
+// Interface used by simulation objects to draw themselves.
+// The simulation never calls OpenGL directly, so it can run without a GL context.
+// The app implements this with OpenGL (see glrenderer.h).
+class Renderer
+{
+public:
+    virtual ~Renderer() {}
+
+    // transform stack, works like glPushMatrix/glTranslate/glPopMatrix
+    virtual void pushTransform(const Vec3& translation) = 0;
+    virtual void popTransform() = 0;
+
+    virtual void drawTriangle(Triangle& triangle) = 0;
+    virtual void drawWall(Wall& wall) = 0;
+    virtual void drawPolygon(ConvexPolygon& polygon) = 0;
+    virtual void drawSphere(Sphere& sphere) = 0;
+    virtual void drawBox(Box& box) = 0;
+    virtual void drawHeightfield(Heightfield& heightfield) = 0;
+
+    // flag of a hole
+    virtual void drawHole(const Vec3& position) = 0;
+    virtual void drawLine(const Vec3& from, const Vec3& to, const Vec3& color, float width) = 0;
+
+    // geometry that looks the same every time it is drawn with the same key, like the static part of a course
+    // a renderer may record it once per key and replay the recording, by default it is drawn directly
+    virtual void drawStatic(unsigned long long /*key*/, const std::function<void(Renderer&)>& drawGeometry) { drawGeometry(*this); }
+};
+
+#endif // RENDERER_HPP
@@ -0,0 +1,64 @@
+#include "shotevaluator.hpp"
+
+namespace golf {
+
+    ShotEvaluator::ShotEvaluator(unsigned int threadCount) {
+        ownPool = std::make_unique<ThreadPool>(threadCount == 0 ? 0 : threadCount - 1);
+        pool = ownPool.get();
+    }
+
+    std::vector<ShotResult> ShotEvaluator::evaluate(Course& course, const Vec3& start, const std::vector<Vec3>& velocities, const ShotSettings& settings) {
+        std::vector<ShotResult> results(velocities.size());
+        // one shot per task, shots that end early leave the rest to be stolen
+        pool->parallelFor(velocities.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                results[i] = simulate(course, start, velocities[i], settings);
+            }
+        });
+        return results;
+    }
+
+    ShotResult ShotEvaluator::simulate(Course& course, const Vec3& start, const Vec3& velocity, const ShotSettings& settings) {
+        static const std::vector<Sphere*> noOtherBalls;
+
+        Golfball ball;
+        ball.setPosition(start);
+        ball.setVelocity(velocity);
+        RestDetector restDetector(settings.rest);
+        restDetector.reset(start);
+        Vec3 down = Game::getDownDirection(settings.gravityDirection);
+
+        ShotResult result;
+        for (unsigned int tick = 0; ; tick++) {
+            // same checks as Game::tick, the first tick is the one the shot is taken in
+            if (tick > 0) {
+                if (Course::isOutOfBounds(ball)) {
+                    result.outcome = ShotOutcome::OUT_OF_BOUNDS;
+                    break;
+                }
+                if (restDetector.update(ball, down)) {
+                    result.outcome = ShotOutcome::RESTING;
+                    break;
+                }
+            }
+            if (course.isInHole(ball)) {
+                result.outcome = ShotOutcome::HOLED;
+                break;
+            }
+            if (tick == settings.maxTicks) {
+                result.outcome = ShotOutcome::TIMEOUT;
+                break;
+            }
+
+            // same steps as Game::step
+            Game::applyGravity(ball, settings.dt, settings.gravityDirection);
+            Game::moveBall(&course, ball, settings.dt, noOtherBalls);
+            course.collide(ball);
+            result.ticks++;
+        }
+
+        result.finalPosition = ball.getPosition();
+        return result;
+    }
+
+}
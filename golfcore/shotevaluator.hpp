@@ -0,0 +1,67 @@
+#ifndef SHOTEVALUATOR_HPP
+#define SHOTEVALUATOR_HPP
+
+#include <vector>
+#include <memory>
+#include "minigolf.hpp"
+#include "threadpool.hpp"
+
+namespace golf
+{
+
+    enum class ShotOutcome
+    {
+        // the ball came to rest on the course
+        RESTING,
+        HOLED,
+        OUT_OF_BOUNDS,
+        // still moving after maxTicks
+        TIMEOUT
+    };
+
+    struct ShotResult
+    {
+        // where the outcome was decided, for out of bounds the game would put the ball back to the start
+        Vec3 finalPosition;
+        ShotOutcome outcome = ShotOutcome::TIMEOUT;
+        // physics steps until the outcome
+        unsigned int ticks = 0;
+    };
+
+    struct ShotSettings
+    {
+        double dt = Game::fixedDt;
+        int gravityDirection = 0;
+        unsigned int maxTicks = 60 * 60;
+        RestSettings rest;
+    };
+
+    // Simulates batches of shots on a thread pool
+    // Every shot is a single golfball on the course with the same steps and rules as Game::update:
+    // hole, out of bounds and rest detection as in Course::checkHole and Game::tick.
+    // Moving obstacles are frozen during evaluation: the course is only read, never ticked,
+    // so every shot sees them at their transforms from the start of the call.
+    // On courses with moving obstacles (e.g. the pillar of Course4) a result can differ from the same shot in a game.
+    class ShotEvaluator
+    {
+    private:
+        std::unique_ptr<ThreadPool> ownPool;
+        ThreadPool *pool;
+
+    public:
+        // own pool with this many threads including the calling one, 0 uses one thread per core
+        explicit ShotEvaluator(unsigned int threadCount = 0);
+        // shares the pool, e.g. with games
+        explicit ShotEvaluator(ThreadPool &pool) : pool(&pool) {}
+
+        // simulates a shot from start with each velocity, results are in the same order
+        // the course needs a built index and must not change during the call, its moving obstacles do not move
+        std::vector<ShotResult> evaluate(Course &course, const Vec3 &start, const std::vector<Vec3> &velocities, const ShotSettings &settings = ShotSettings());
+        // simulates one shot on the calling thread, with the moving obstacles frozen like evaluate
+        static ShotResult simulate(Course &course, const Vec3 &start, const Vec3 &velocity, const ShotSettings &settings = ShotSettings());
+        unsigned int getThreadCount() { return pool->getThreadCount(); }
+    };
+
+};
+
+#endif // SHOTEVALUATOR_HPP
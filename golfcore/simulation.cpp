@@ -0,0 +1,1170 @@
+
+#include "simulation.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+// Swept sphere helpers
+// they return the fraction of motion at which the moving center gets within radius, or INFINITY
+// a center that is already within radius and moves further in hits at 0
+
+// moving point against a sphere around a fixed point
+static double sweepPoint(const Vec3 &start, const Vec3 &motion, const Vec3 &point, double radius)
+{
+    Vec3 m = start - point;
+    double a = motion.dot(motion);
+    double b = 2 * m.dot(motion);
+    double c = m.dot(m) - radius * radius;
+    // not moving closer
+    if (a == 0.0 || b >= 0)
+        return INFINITY;
+    if (c <= 0)
+        return 0;
+    double disc = b * b - 4 * a * c;
+    if (disc < 0)
+        return INFINITY;
+    double t = (-b - sqrt(disc)) / (2 * a);
+    return (t >= 0 && t <= 1) ? t : INFINITY;
+}
+
+// moving point against a cylinder around an edge, direction is normalized
+static double sweepEdge(const Vec3 &start, const Vec3 &motion, const Vec3 &corner, const Vec3 &direction, double length, double radius)
+{
+    // only the part orthogonal to the edge matters
+    Vec3 m = start - corner;
+    Vec3 mOrtho = m - direction * m.dot(direction);
+    Vec3 dOrtho = motion - direction * motion.dot(direction);
+    double a = dOrtho.dot(dOrtho);
+    double b = 2 * mOrtho.dot(dOrtho);
+    double c = mOrtho.dot(mOrtho) - radius * radius;
+    if (a < 1e-12 || b >= 0)
+        return INFINITY;
+    double t = 0;
+    if (c > 0)
+    {
+        double disc = b * b - 4 * a * c;
+        if (disc < 0)
+            return INFINITY;
+        t = (-b - sqrt(disc)) / (2 * a);
+        if (t < 0 || t > 1)
+            return INFINITY;
+    }
+
+    // hit has to be between both corners
+    double along = (m + motion * t).dot(direction);
+    if (along < 0 || along > length)
+        return INFINITY;
+    return t;
+}
+
+// moving sphere against a flat convex polygon
+// edges and corners are skipped for faceOnly, like in Triangle::findContacts
+static double sweepPolygon(const Vec3 *corners, const Vec3 *edgeDirections, const double *edgeLengths, int count,
+                           const Vec3 &normal, const Vec3 &start, const Vec3 &motion, double radius, bool faceOnly)
+{
+    double startDist = normal.dot(start - corners[0]);
+    double endDist = normal.dot(start + motion - corners[0]);
+
+    // never gets close to the plane
+    if ((startDist > radius && endDist > radius) || (startDist < -radius && endDist < -radius))
+        return INFINITY;
+
+    double sweepRadius = radius - SWEEP_SLOP;
+    double t = INFINITY;
+
+    // face, seen from the side the sphere starts on
+    double side = startDist < 0 ? -1 : 1;
+    double s0 = side * startDist;
+    double s1 = side * endDist;
+    if (s1 < sweepRadius && s1 < s0)
+    {
+        double tFace = s0 > sweepRadius ? (s0 - sweepRadius) / (s0 - s1) : 0;
+        Vec3 contact = start + motion * tFace - normal * (side * sweepRadius);
+
+        // inside if the contact is on the same side of all edges
+        int positive = 0;
+        int negative = 0;
+        for (int i = 0; i < count; i++)
+        {
+            double edgeSide = edgeDirections[i].cross(contact - corners[i]).dot(normal);
+            if (edgeSide >= 0)
+                positive++;
+            if (edgeSide <= 0)
+                negative++;
+        }
+        if (positive == count || negative == count)
+            t = tFace;
+    }
+
+    if (faceOnly)
+        return t;
+
+    for (int i = 0; i < count; i++)
+    {
+        t = std::min(t, sweepEdge(start, motion, corners[i], edgeDirections[i], edgeLengths[i], sweepRadius));
+        t = std::min(t, sweepPoint(start, motion, corners[i], sweepRadius));
+    }
+
+    return t;
+}
+
+// contacts of sphere with wall
+void Wall::findContacts(Sphere &sphere, ContactManifold &manifold)
+{
+    updateWorldTransform();
+
+    // cheap distance check first
+    const auto &normal = baked.normal;
+    const auto *worldCorners = baked.corners;
+    const auto &point = worldCorners[0];
+    const auto center = sphere.getWorldPosition();
+    auto radius = sphere.getRadius();
+    auto dist = abs(normal.dot(center - point));
+
+    if (dist > radius)
+        return;
+
+    // check for corner collision here
+    for (int i = 0; i < 4; i++)
+    {
+        const auto &corner = worldCorners[i];
+        auto vec = center - corner;
+        double cornerDist = vec.length();
+        if (cornerDist < radius)
+        {
+            // collision confirmed, the sphere bounces off the corner
+            manifold.add({vec / cornerDist, radius - cornerDist + 0.001, 1, 0});
+            return;
+        }
+    }
+
+    // check if sphere collides with edge
+
+    for (int i = 0; i < 4; i++)
+    {
+        auto &corner1 = worldCorners[i];
+        auto &corner2 = worldCorners[(i + 1) % 4];
+        const auto &edgeNormalized = baked.edgeDirections[i];
+
+        auto ca = center - corner1;
+
+        // calculate distance to edge
+        // distance from corner1 to closest point on edge
+        auto edgedist = edgeNormalized.dot(ca);
+        auto closestPoint = corner1 + edgedist * edgeNormalized;
+        double cpdist = closestPoint.getDistance(center);
+        if (cpdist > radius)
+            continue;
+
+        // calculate closest point on edge to sphere center
+        // double t = ca.dot(edge) / edge.dot(edge);
+        // auto p = corner1 + t * edge;
+        auto &p = closestPoint;
+
+        // check if collision point is between both worldCorners by checking if distance |p-corner1| + |p-corner2| is equal to |corner1-corner2|
+        auto dist1 = p.getDistance(corner1);
+        auto dist2 = p.getDistance(corner2);
+        auto dist3 = baked.edgeLengths[i];
+        constexpr double tolerance = 0.01;
+        if (dist1 + dist2 > dist3 + tolerance)
+            continue;
+
+        // collision confirmed, the sphere bounces off the edge
+        auto collToCenter = (center - p) / cpdist;
+        manifold.add({collToCenter, radius - cpdist + 0.001, 1, 0});
+    }
+
+    // check if sphere collides with face
+    // already in range of plane, check if collisionpoint is inside face
+    // face normal: normal
+    // face point: worldCorners[0]
+
+    // calculate closest point on plate to sphere center
+
+    // use non abs distance to get direction
+    auto newDist = normal.dot(center - point);
+    auto p = center - newDist * normal;
+
+    // check if collision point is between all worldCorners
+
+    // convert wall to 2d rectangle
+    // wall[0] = 0/0
+    // wall[1] = 0/1
+    // wall[2] = 1/1
+    // wall[3] = 1/0
+
+    // vectors spanning the rectangle and the plane normal are baked (see Wall::onWorldPositionChanged)
+    const auto &v1 = baked.v1;
+    const auto &v2 = baked.v2;
+    const auto &n = baked.n;
+
+    // convert a point to 2d:
+    // px = v1.dot(p - worldCorners[0])
+    // py = v2.dot(p - worldCorners[0])
+    // pz = n.dot(p - worldCorners[0])
+    // pz should be 0 and can be ignored, px and py form the 2d point
+
+    // max values for height and width
+    auto trX = baked.trX;
+    auto trY = baked.trY;
+
+    // vector from corner to point
+    auto pnew = p - worldCorners[0];
+
+    // calculate px, py and pz
+    auto px = v1.dot(pnew) / trX;
+    auto py = v2.dot(pnew) / trY;
+    auto pz = n.dot(pnew);
+
+    // check if pz is 0 with tolerance
+    // should always be near 0 since we already checked distance
+    if (pz > 0.01 || pz < -0.01)
+        return;
+
+    // check if px and py are between 0 and trX and trY
+    if (px < 0 || px > 1 || py < 0 || py > 1)
+        return;
+
+    // barycentric approach
+    // works, but currently not used
+    // is also slower
+    // create two triangles from worldCorners
+    /*
+    bool isInside = false;
+    for (int i = 0; i < 3; i += 2)
+    {
+        // calculate using barycentric coordinates
+        auto a = worldCorners[i];
+        auto b = worldCorners[i + 1];
+        auto c = worldCorners[(i + 2) % 4];
+
+        // vectors from a to b and a to c and a to p
+        Vec3 v0 = c - a;
+        Vec3 v1 = b - a;
+        Vec3 v2 = p - a;
+
+        // dot products
+        double dot00 = v0.dot(v0);
+        double dot01 = v0.dot(v1);
+        double dot02 = v0.dot(v2);
+        double dot11 = v1.dot(v1);
+        double dot12 = v1.dot(v2);
+
+        // inverse denominator to avoid division later
+        double invDenom = 1.0 / (dot00 * dot11 - dot01 * dot01);
+
+        // barycentric coordinates
+        double u = (dot11 * dot02 - dot01 * dot12) * invDenom;
+        double v = (dot00 * dot12 - dot01 * dot02) * invDenom;
+
+        // check if point is in triangle
+        double tolerance = 0;
+        if ((u >= -tolerance) && (v >= -tolerance) && (u + v <= 1.0 + tolerance))
+        {
+            isInside = true;
+            break;
+        }
+    }
+
+    if (!isInside)
+        return false;
+    */
+
+    // collision confirmed, the sphere bounces off the face
+    // instead of normal use collToCenter
+    // this is the same direction as the normal, but it can be negative if the sphere is on the other side of the wall
+    auto collToCenter = newDist < 0 ? -normal : normal;
+    manifold.add({collToCenter, radius - dist + 0.001, 1, 0});
+}
+
+void ContactManifold::add(const Contact &contact)
+{
+    if (count < maxContacts)
+    {
+        contacts[count++] = contact;
+        return;
+    }
+    auto shallowest = std::min_element(contacts.begin(), contacts.end(),
+                                       [](const Contact &a, const Contact &b) { return a.depth < b.depth; });
+    if (shallowest->depth < contact.depth)
+        *shallowest = contact;
+}
+
+// sequential impulses: each contact in turn takes away the approach speed the others left
+// the impulse summed up per contact only ever pushes, so a contact can give back what it took too much
+bool ContactManifold::solve(Sphere &sphere) const
+{
+    if (count == 0)
+    {
+        sphere.clearSupport();
+        return false;
+    }
+
+    Vec3 velocity = sphere.getVelocity();
+    std::array<double, maxContacts> targetSpeed;
+    std::array<double, maxContacts> impulse;
+    for (size_t i = 0; i < count; i++)
+    {
+        // speed away from the surface after the contact, bouncing surfaces give back part of the approach speed
+        double approach = -velocity.dot(contacts[i].normal);
+        targetSpeed[i] = approach > bounceSpeed ? contacts[i].restitution * approach : 0;
+        impulse[i] = 0;
+    }
+    for (int iteration = 0; iteration < solverIterations; iteration++)
+    {
+        double change = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            double newImpulse = std::max(impulse[i] + targetSpeed[i] - velocity.dot(contacts[i].normal), 0.0);
+            velocity += contacts[i].normal * (newImpulse - impulse[i]);
+            change = std::max(change, std::abs(newImpulse - impulse[i]));
+            impulse[i] = newImpulse;
+        }
+        if (change < 1e-12)
+            break;
+    }
+
+    // friction slows the sliding along each surface by at most friction times the impulse into it
+    // a ball resting on the ground takes gravity as impulse, so it loses mu * g * dt per step
+    for (size_t i = 0; i < count; i++)
+    {
+        if (contacts[i].friction == 0)
+            continue;
+        const Vec3 &normal = contacts[i].normal;
+        Vec3 sliding = velocity - normal * velocity.dot(normal);
+        double speed = sliding.length();
+        double loss = contacts[i].friction * impulse[i];
+        velocity -= speed > loss ? sliding * (loss / speed) : sliding;
+    }
+    sphere.setVelocity(velocity);
+
+    // what held the sphere, for rest detection
+    Vec3 push(0);
+    double totalImpulse = 0;
+    double friction = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        push += contacts[i].normal * impulse[i];
+        totalImpulse += impulse[i];
+        friction += contacts[i].friction * impulse[i];
+    }
+    if (push.lengthSquared() > 0)
+        sphere.setSupport(push.normalized(), friction / totalImpulse);
+    else
+        sphere.clearSupport();
+
+    // the same for the position, each contact moves the sphere out as far as the others did not already
+    Vec3 move(0);
+    for (int iteration = 0; iteration < solverIterations; iteration++)
+    {
+        bool separated = true;
+        for (size_t i = 0; i < count; i++)
+        {
+            double depth = contacts[i].depth - move.dot(contacts[i].normal);
+            if (depth > 0)
+            {
+                move += contacts[i].normal * depth;
+                separated = false;
+            }
+        }
+        if (separated)
+            break;
+    }
+    sphere.move(move);
+    return true;
+}
+
+// collision of sphere with sphere
+void Sphere::bounce(Sphere &other)
+{
+    // calculate reflection vector
+    auto mass1 = this->getMass();
+    auto mass2 = other.getMass();
+    auto v1 = this->getVelocity();
+    auto v2 = other.getVelocity();
+    auto p1 = this->getWorldPosition();
+    auto p2 = other.getWorldPosition();
+
+    // calculate new velocities
+    // collision point based on radius
+    auto coll = (p1 - p2).normalized() * this->getRadius();
+    coll += p1;
+    // calculate new velocities
+    // new vel = old vel - 2 * massFactor * collisionFactor / distance^2 * collisionVector
+    auto v1f = v1 - 2 * mass2 / (mass1 + mass2) * (v1 - v2).dot(p1 - coll) / pow((p1 - coll).length(), 2) * (p1 - coll);
+    auto v2f = v2 - 2 * mass1 / (mass1 + mass2) * (v2 - v1).dot(p2 - coll) / pow((p2 - coll).length(), 2) * (p2 - coll);
+
+    double bounce = calcBounceFactor(other);
+
+    this->setVelocity(v1f*bounce);
+    other.setVelocity(v2f*bounce);
+    this->wake();
+    other.wake();
+
+    // move spheres out of each other
+    auto dist = (this->getRadius() + other.getRadius()) * 1.001;
+    auto vec = this->getWorldPosition() - other.getWorldPosition();
+    auto moveDirection = vec.normalized();
+    auto move = moveDirection * (dist - vec.length());
+    this->move(move);
+    other.move(move * -1);
+}
+
+double SimObject::calcBounceFactor(const SimObject &other)
+{
+
+    double factor = (other.bounceFactor * this->bounceFactor);
+    return factor;
+}
+
+void SimObject::tick(double time)
+{
+    // tick children
+    for (SimObject *child : children)
+    {
+        child->tick(time);
+    }
+}
+
+void SimObject::setPosition(Vec3 position)
+{
+    // children notice through transformGeneration once this is recomputed
+    this->position = position;
+    transformDirty = true;
+}
+
+void SimObject::updateWorldTransform()
+{
+    if (parent != nullptr)
+    {
+        parent->updateWorldTransform();
+        if (parent->transformGeneration != parentGeneration)
+        {
+            worldPosition = parent->worldPosition + parent->position;
+            parentGeneration = parent->transformGeneration;
+            transformDirty = true;
+        }
+    }
+    if (!transformDirty)
+        return;
+    transformDirty = false;
+    transformGeneration++;
+    onWorldPositionChanged();
+}
+
+bool SimObject::collide(Sphere& sphere) {
+    ContactManifold manifold;
+    findContacts(sphere, manifold);
+    return manifold.solve(sphere);
+}
+
+void SimObject::findContacts(Sphere& sphere, ContactManifold& manifold) {
+    // check collision with children
+    for (SimObject *child : children)
+    {
+        child->findContacts(sphere, manifold);
+    }
+}
+
+AABB SimObject::getBounds()
+{
+    AABB bounds;
+    for (SimObject *child : children)
+    {
+        bounds.expand(child->getBounds());
+    }
+    return bounds;
+}
+
+double SimObject::sweep(Sphere &sphere, const Vec3 &motion)
+{
+    double t = INFINITY;
+    for (SimObject *child : children)
+    {
+        t = std::min(t, child->sweep(sphere, motion));
+    }
+    return t;
+}
+
+void SimObject::addChild(SimObject *child)
+{
+    children.push_back(child);
+    child->parent = this;
+    // a generation the parent never had, so the child recomputes on the next read
+    child->parentGeneration = ULLONG_MAX;
+}
+
+void SimObject::draw(Renderer &renderer)
+{
+    drawChildrenAt(renderer, position);
+}
+
+void SimObject::drawChildrenAt(Renderer &renderer, const Vec3 &position)
+{
+    renderer.pushTransform(position);
+
+    // draw children
+    for (SimObject *child : children)
+    {
+        child->draw(renderer);
+    }
+
+    renderer.popTransform();
+}
+
+Triangle::Triangle(const Vec3 &p1, const Vec3 &p2, const Vec3 &p3)
+{
+    this->p1 = p1;
+    this->p2 = p2;
+    this->p3 = p3;
+}
+
+void Triangle::draw(Renderer &renderer)
+{
+    renderer.drawTriangle(*this);
+
+    SimObject::draw(renderer);
+}
+
+void Triangle::findContacts(Sphere &sphere, ContactManifold &manifold)
+{
+    updateWorldTransform();
+
+    // cheap distance check first
+    const auto &normal = baked.normal;
+    const auto *worldCorners = baked.corners;
+    const auto &point = worldCorners[0];
+    const auto center = sphere.getWorldPosition();
+    auto radius = sphere.getRadius();
+    auto dist = abs(normal.dot(center - point));
+
+    if (dist > radius)
+        return;
+
+    double bounceFactor = sphere.calcBounceFactor(*this);
+
+    // check for corner collision here
+    if (!faceCollisionOnly)
+        for (int i = 0; i < 3; i++)
+        {
+            const auto &corner = worldCorners[i];
+            auto vec = center - corner;
+            double cornerDist = vec.length();
+            if (cornerDist < radius)
+            {
+                // collision confirmed, the sphere bounces off the corner
+                manifold.add({vec / cornerDist, radius - cornerDist + 0.001, bounceFactor, 0});
+                return;
+            }
+        }
+
+    // check if sphere collides with edge
+    if (!faceCollisionOnly)
+        for (int i = 0; i < 3; i++)
+        {
+            auto &corner1 = worldCorners[i];
+            auto &corner2 = worldCorners[(i + 1) % 3];
+            const auto &edgeNormalized = baked.edgeDirections[i];
+
+            auto ca = center - corner1;
+
+            // calculate distance to edge
+            // distance from corner1 to closest point on edge
+            auto edgedist = edgeNormalized.dot(ca);
+            auto closestPoint = corner1 + edgedist * edgeNormalized;
+            double cpdist = closestPoint.getDistance(center);
+            if (cpdist > radius)
+                continue;
+
+            // calculate closest point on edge to sphere center
+            // double t = ca.dot(edge) / edge.dot(edge);
+            // auto p = corner1 + t * edge;
+            auto &p = closestPoint;
+
+            // check if collision point is between both worldCorners by checking if distance |p-corner1| + |p-corner2| is equal to |corner1-corner2|
+            auto dist1 = p.getDistance(corner1);
+            auto dist2 = p.getDistance(corner2);
+            auto dist3 = baked.edgeLengths[i];
+            constexpr double tolerance = 0.01;
+            if (dist1 + dist2 > dist3 + tolerance)
+                continue;
+
+            // collision confirmed, the sphere bounces off the edge
+            auto collToCenter = (center - p) / cpdist;
+            manifold.add({collToCenter, radius - cpdist + 0.001, bounceFactor, 0});
+        }
+
+    // check if sphere collides with face
+    // already in range of plane, check if collisionpoint is inside face
+    // face normal: normal
+    // face point: worldCorners[0]
+
+    // calculate closest point on plate to sphere center
+
+    // use non abs distance to get direction
+    auto newDist = normal.dot(center - point);
+    auto p = center - newDist * normal;
+
+    // check if collision point is between all worldCorners
+
+    // barycentric approach
+
+    // calculate using barycentric coordinates
+    // terms that only depend on the corners are baked (see Triangle::onWorldPositionChanged)
+    auto &a = worldCorners[0];
+
+    // vectors from a to b and a to c and a to p
+    const Vec3 &v0 = baked.v0;
+    const Vec3 &v1 = baked.v1;
+    Vec3 v2 = p - a;
+
+    // dot products
+    double dot00 = baked.dot00;
+    double dot01 = baked.dot01;
+    double dot02 = v0.dot(v2);
+    double dot11 = baked.dot11;
+    double dot12 = v1.dot(v2);
+
+    // inverse denominator to avoid division later
+    double invDenom = baked.invDenom;
+
+    // barycentric coordinates
+    double u = (dot11 * dot02 - dot01 * dot12) * invDenom;
+    double v = (dot00 * dot12 - dot01 * dot02) * invDenom;
+
+    // check if point is in triangle
+    double tolerance = 0;
+    if (!((u >= -tolerance) && (v >= -tolerance) && (u + v <= 1.0 + tolerance)))
+    {
+        return;
+    }
+
+    // collision confirmed, the sphere rolls on the face
+    // instead of normal use collToCenter
+    // this is the same direction as the normal, but it can be negative if the sphere is on the other side of the wall
+    auto collToCenter = newDist < 0 ? -normal : normal;
+    manifold.add({collToCenter, radius - dist + 0.001, 0, frictionCoefficient});
+}
+
+double Triangle::sweep(Sphere &sphere, const Vec3 &motion)
+{
+    updateWorldTransform();
+    return sweepPolygon(baked.corners, baked.edgeDirections, baked.edgeLengths, 3, baked.normal,
+                        sphere.getWorldPosition(), motion, sphere.getRadius(), faceCollisionOnly);
+}
+
+void Triangle::onWorldPositionChanged()
+{
+    auto worldPos = getWorldPosition();
+    baked.corners[0] = worldPos + p1;
+    baked.corners[1] = worldPos + p2;
+    baked.corners[2] = worldPos + p3;
+    baked.normal = getNormal();
+
+    for (int i = 0; i < 3; i++)
+    {
+        const auto &corner1 = baked.corners[i];
+        const auto &corner2 = baked.corners[(i + 1) % 3];
+        baked.edgeDirections[i] = (corner2 - corner1).normalized();
+        baked.edgeLengths[i] = corner1.getDistance(corner2);
+    }
+
+    const auto &a = baked.corners[0];
+    baked.v0 = baked.corners[2] - a;
+    baked.v1 = baked.corners[1] - a;
+    baked.dot00 = baked.v0.dot(baked.v0);
+    baked.dot01 = baked.v0.dot(baked.v1);
+    baked.dot11 = baked.v1.dot(baked.v1);
+    baked.invDenom = 1.0 / (baked.dot00 * baked.dot11 - baked.dot01 * baked.dot01);
+}
+
+std::array<Vec3, 3> Triangle::getWorldCorners()
+{
+    auto worldPos = getWorldPosition();
+    return {
+        worldPos + p1,
+        worldPos + p2,
+        worldPos + p3,
+    };
+}
+
+AABB Triangle::getBounds()
+{
+    AABB bounds;
+    for (const auto &corner : getWorldCorners())
+    {
+        bounds.expand(corner);
+    }
+    bounds.expand(SimObject::getBounds());
+    return bounds;
+}
+
+Plane::Plane(Vec3 normal, Vec3 point) : normal(normal), point(point)
+{
+    this->normal = this->normal.normalized();
+}
+
+double Plane::getDistance(const Vec3 &other)
+{
+    return abs((other - point).dot(normal));
+}
+
+Vec3 Plane::bounce(const Vec3 &v)
+{
+    // calculate reflection vector
+    // skalarprodukt
+    double dot = v.dot(normal);
+    // reflektionsvektor
+    Vec3 reflection = v - 2 * dot * normal;
+    return reflection;
+}
+
+Wall::Wall(double x1, double z1, double x2, double z2) : SimObject()
+{
+    constexpr double HEIGHT = 2;
+    corners = {Vec3(x1, 0, z1), Vec3(x1, HEIGHT, z1), Vec3(x2, HEIGHT, z2), Vec3(x2, 0, z2)};
+}
+
+void Wall::draw(Renderer &renderer)
+{
+    renderer.drawWall(*this);
+
+    SimObject::draw(renderer);
+}
+
+Wall::Wall(const Vec3 &corner1, const Vec3 &corner2, const Vec3 &corner3, const Vec3 &corner4) : SimObject()
+{
+    corners = {corner1, corner2, corner3, corner4};
+}
+
+double Wall::sweep(Sphere &sphere, const Vec3 &motion)
+{
+    updateWorldTransform();
+    return sweepPolygon(baked.corners, baked.edgeDirections, baked.edgeLengths, 4, baked.normal,
+                        sphere.getWorldPosition(), motion, sphere.getRadius(), false);
+}
+
+void Wall::onWorldPositionChanged()
+{
+    auto wPos = this->getWorldPosition();
+    for (int i = 0; i < 4; i++)
+    {
+        baked.corners[i] = corners[i] + wPos;
+    }
+    baked.normal = getNormal();
+
+    for (int i = 0; i < 4; i++)
+    {
+        const auto &corner1 = baked.corners[i];
+        const auto &corner2 = baked.corners[(i + 1) % 4];
+        baked.edgeDirections[i] = (corner2 - corner1).normalized();
+        baked.edgeLengths[i] = corner1.getDistance(corner2);
+    }
+
+    // wall as 2d rectangle
+    // wall[0] = 0/0
+    // wall[1] = 0/1
+    // wall[2] = 1/1
+    // wall[3] = 1/0
+    baked.v1 = (baked.corners[1] - baked.corners[0]).normalized();
+    baked.v2 = (baked.corners[3] - baked.corners[0]).normalized();
+    baked.n = baked.v1.cross(baked.v2).normalized();
+
+    // max values for height and width
+    auto topRight = baked.corners[2] - baked.corners[0];
+    baked.trX = baked.v1.dot(topRight);
+    baked.trY = baked.v2.dot(topRight);
+}
+
+std::array<Vec3, 4> Wall::getWorldCorners()
+{
+    auto wPos = this->getWorldPosition();
+    return {
+        corners[0] + wPos,
+        corners[1] + wPos,
+        corners[2] + wPos,
+        corners[3] + wPos};
+}
+
+AABB Wall::getBounds()
+{
+    AABB bounds;
+    for (const auto &corner : getWorldCorners())
+    {
+        bounds.expand(corner);
+    }
+    bounds.expand(SimObject::getBounds());
+    return bounds;
+}
+
+ConvexPolygon::ConvexPolygon(const std::vector<Vec3> &corners) : SimObject(), corners(corners)
+{
+    normal = corners[0].getNormal(corners[1], corners[2]);
+}
+
+void ConvexPolygon::draw(Renderer &renderer)
+{
+    renderer.drawPolygon(*this);
+
+    SimObject::draw(renderer);
+}
+
+void ConvexPolygon::onWorldPositionChanged()
+{
+    auto worldPos = getWorldPosition();
+    size_t count = corners.size();
+    worldCorners.resize(count);
+    edgeDirections.resize(count);
+    edgeLengths.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        worldCorners[i] = worldPos + corners[i];
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto &corner1 = worldCorners[i];
+        const auto &corner2 = worldCorners[(i + 1) % count];
+        edgeDirections[i] = (corner2 - corner1).normalized();
+        edgeLengths[i] = corner1.getDistance(corner2);
+    }
+}
+
+// like the face of a triangle, the closest point on the plane has to be inside on the same side of every edge
+void ConvexPolygon::findContacts(Sphere &sphere, ContactManifold &manifold)
+{
+    updateWorldTransform();
+
+    const auto center = sphere.getWorldPosition();
+    auto radius = sphere.getRadius();
+    auto newDist = normal.dot(center - worldCorners[0]);
+    auto dist = abs(newDist);
+    if (dist > radius)
+        return;
+
+    auto p = center - newDist * normal;
+    size_t positive = 0;
+    size_t negative = 0;
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        double edgeSide = edgeDirections[i].cross(p - worldCorners[i]).dot(normal);
+        if (edgeSide >= 0)
+            positive++;
+        if (edgeSide <= 0)
+            negative++;
+    }
+    if (positive != corners.size() && negative != corners.size())
+        return;
+
+    auto collToCenter = newDist < 0 ? -normal : normal;
+    manifold.add({collToCenter, radius - dist + 0.001, 0, frictionCoefficient});
+}
+
+double ConvexPolygon::sweep(Sphere &sphere, const Vec3 &motion)
+{
+    updateWorldTransform();
+    return sweepPolygon(worldCorners.data(), edgeDirections.data(), edgeLengths.data(), static_cast<int>(corners.size()), normal,
+                        sphere.getWorldPosition(), motion, sphere.getRadius(), true);
+}
+
+AABB ConvexPolygon::getBounds()
+{
+    updateWorldTransform();
+    AABB bounds;
+    for (const auto &corner : worldCorners)
+    {
+        bounds.expand(corner);
+    }
+    bounds.expand(SimObject::getBounds());
+    return bounds;
+}
+
+void Sphere::draw(Renderer &renderer)
+{
+    renderer.drawSphere(*this);
+
+    SimObject::draw(renderer);
+}
+
+void Sphere::move(Vec3 v)
+{
+    if (v.lengthSquared() == 0.0)
+        return;
+    Vec3 &floor = this->getFloorNormal();
+    if (floor.lengthSquared() < 0.01)
+    {
+        // no floor
+        setPosition(this->getPosition() + v);
+        return;
+    }
+
+    // calculate axis
+    auto vnorm = v.normalized();
+    auto cross = vnorm.cross(floor);
+    if (cross.lengthSquared() < 0.00001)
+    {
+        // no rotation
+        setPosition(this->getPosition() + v);
+        return;
+    }
+    auto rot = cross.normalized();
+
+    // calculate angle
+    // idk why -
+    auto angle = -v.length() * (1-v.dot(getFloorNormal())) / radius;
+    // renormalized so rounding does not add up over long rolls
+    orientation = (Quaternion::fromAxisAngle(rot, angle) * orientation).normalized();
+    setPosition(this->getPosition() + v);
+}
+
+void Sphere::updateSleep()
+{
+    if (sleeping)
+        return;
+    if (velocity.length() >= sleepSpeed)
+    {
+        slowSteps = 0;
+        return;
+    }
+    if (++slowSteps >= sleepSteps)
+    {
+        sleeping = true;
+        velocity = Vec3(0);
+    }
+}
+
+void Sphere::moveTo(Vec3 v)
+{
+    auto diff = v - getWorldPosition();
+    move(diff);
+}
+
+double Sphere::getMass()
+{
+    return 4.0 / 3.0 * PI * pow(radius, 3) * density;
+}
+
+double Sphere::sweep(Sphere &sphere, const Vec3 &motion)
+{
+    if (&sphere == this)
+        return INFINITY;
+    auto start = sphere.getWorldPosition();
+    auto center = getWorldPosition();
+    double radius = this->radius + sphere.getRadius();
+    return sweepPoint(start, motion, center, radius - SWEEP_SLOP);
+}
+
+AABB Sphere::getBounds()
+{
+    auto center = getWorldPosition();
+    AABB bounds(center - Vec3(radius), center + Vec3(radius));
+    bounds.expand(SimObject::getBounds());
+    return bounds;
+}
+
+void AABB::expand(const Vec3 &p)
+{
+    min = Vec3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+    max = Vec3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+}
+
+void AABB::expand(const AABB &other)
+{
+    if (other.isEmpty())
+        return;
+    expand(other.min);
+    expand(other.max);
+}
+
+bool AABB::overlaps(const AABB &other) const
+{
+    return min.x <= other.max.x && max.x >= other.min.x &&
+           min.y <= other.max.y && max.y >= other.min.y &&
+           min.z <= other.max.z && max.z >= other.min.z;
+}
+
+bool AABB::contains(const AABB &other) const
+{
+    return min.x <= other.min.x && max.x >= other.max.x &&
+           min.y <= other.min.y && max.y >= other.max.y &&
+           min.z <= other.min.z && max.z >= other.max.z;
+}
+
+Box::Box(const std::vector<double> &xnzn) : SimObject()
+{
+    // xnzn = x1, z1, x2, z2, ...
+    // create walls from xnzn
+    for (size_t i = 0; i < xnzn.size(); i += 2)
+    {
+        walls.push_back(Wall(xnzn[i], xnzn[i + 1], xnzn[(i + 2) % xnzn.size()], xnzn[(i + 3) % xnzn.size()]));
+        outerWallCount++;
+    }
+}
+
+void Box::draw(Renderer &renderer)
+{
+    renderer.drawBox(*this);
+}
+
+Heightfield::Heightfield(double minX, double minZ, double maxX, double maxZ, double resolution, const std::function<double(double, double)> &heightFunction)
+    : SimObject(), minX(minX), minZ(minZ), resolution(resolution)
+{
+    cellsX = static_cast<int>(std::round((maxX - minX) / resolution));
+    cellsZ = static_cast<int>(std::round((maxZ - minZ) / resolution));
+
+    heights.resize(static_cast<size_t>(cellsX + 1) * (cellsZ + 1));
+    minHeight = INFINITY;
+    maxHeight = -INFINITY;
+    for (int x = 0; x <= cellsX; x++)
+    {
+        for (int z = 0; z <= cellsZ; z++)
+        {
+            double height = heightFunction(minX + x * resolution, minZ + z * resolution);
+            heights[x * (cellsZ + 1) + z] = height;
+            minHeight = std::min(minHeight, height);
+            maxHeight = std::max(maxHeight, height);
+        }
+    }
+
+    buildMesh();
+}
+
+bool Heightfield::sample(double x, double z, double &height, Vec3 &normal) const
+{
+    double gridX = (x - minX) / resolution;
+    double gridZ = (z - minZ) / resolution;
+    if (!(gridX >= 0 && gridX <= cellsX && gridZ >= 0 && gridZ <= cellsZ))
+        return false;
+
+    // the far border belongs to the last cell
+    int cellX = std::min(static_cast<int>(gridX), cellsX - 1);
+    int cellZ = std::min(static_cast<int>(gridZ), cellsZ - 1);
+    double fx = gridX - cellX;
+    double fz = gridZ - cellZ;
+
+    double h00 = getHeight(cellX, cellZ);
+    double h10 = getHeight(cellX + 1, cellZ);
+    double h01 = getHeight(cellX, cellZ + 1);
+    double h11 = getHeight(cellX + 1, cellZ + 1);
+
+    // height is linear over the triangle of the cell the point is in
+    if (fx + fz <= 1)
+        height = h00 + fx * (h10 - h00) + fz * (h01 - h00);
+    else
+        height = h11 - (1 - fx) * (h11 - h01) - (1 - fz) * (h11 - h10);
+
+    // the normal is blended from the corners, so it turns smoothly from cell to cell
+    normal = (getSampleNormal(cellX, cellZ) * ((1 - fx) * (1 - fz)) +
+              getSampleNormal(cellX + 1, cellZ) * (fx * (1 - fz)) +
+              getSampleNormal(cellX, cellZ + 1) * ((1 - fx) * fz) +
+              getSampleNormal(cellX + 1, cellZ + 1) * (fx * fz))
+                 .normalized();
+    return true;
+}
+
+Vec3 Heightfield::getSampleNormal(int x, int z) const
+{
+    int x0 = std::max(x - 1, 0), x1 = std::min(x + 1, cellsX);
+    int z0 = std::max(z - 1, 0), z1 = std::min(z + 1, cellsZ);
+    double slopeX = (getHeight(x1, z) - getHeight(x0, z)) / ((x1 - x0) * resolution);
+    double slopeZ = (getHeight(x, z1) - getHeight(x, z0)) / ((z1 - z0) * resolution);
+    return Vec3(-slopeX, 1, -slopeZ).normalized();
+}
+
+void Heightfield::buildMesh()
+{
+    vertices.clear();
+    normals.clear();
+    vertices.reserve(heights.size() * 3);
+    normals.reserve(heights.size() * 3);
+    for (int x = 0; x <= cellsX; x++)
+    {
+        for (int z = 0; z <= cellsZ; z++)
+        {
+            vertices.push_back(static_cast<float>(minX + x * resolution));
+            vertices.push_back(static_cast<float>(getHeight(x, z)));
+            vertices.push_back(static_cast<float>(minZ + z * resolution));
+
+            Vec3 normal = getSampleNormal(x, z);
+            normals.push_back(static_cast<float>(normal.x));
+            normals.push_back(static_cast<float>(normal.y));
+            normals.push_back(static_cast<float>(normal.z));
+        }
+    }
+
+    // one strip along z per column of cells, joined by repeating the last and first index
+    // (x, z), (x + 1, z), (x, z + 1), ... splits the cells along the same diagonal as sample()
+    stripIndices.clear();
+    stripIndices.reserve(static_cast<size_t>(cellsX) * (2 * (cellsZ + 1) + 2));
+    for (int x = 0; x < cellsX; x++)
+    {
+        if (x > 0)
+            stripIndices.push_back(x * (cellsZ + 1));
+        for (int z = 0; z <= cellsZ; z++)
+        {
+            stripIndices.push_back(x * (cellsZ + 1) + z);
+            stripIndices.push_back((x + 1) * (cellsZ + 1) + z);
+        }
+        if (x < cellsX - 1)
+            stripIndices.push_back(stripIndices.back());
+    }
+}
+
+void Heightfield::draw(Renderer &renderer)
+{
+    renderer.drawHeightfield(*this);
+
+    SimObject::draw(renderer);
+}
+
+// against the surface below the center of the sphere, answered by the cell it is over
+void Heightfield::findContacts(Sphere &sphere, ContactManifold &manifold)
+{
+    auto center = sphere.getWorldPosition() - getWorldPosition();
+    auto radius = sphere.getRadius();
+    double height;
+    Vec3 normal;
+    if (!sample(center.x, center.z, height, normal))
+        return;
+
+    // distance to the surface along its normal, negative below it
+    double dist = (center.y - height) * normal.y;
+    // like the face of a ground tile, a ball more than its radius below the surface is not touching it,
+    // it went under the ground and must not be pushed up through it
+    if (abs(dist) > radius)
+        return;
+
+    // the sphere is pushed up, also when its center is just below the surface
+    manifold.add({normal, radius - dist + 0.001, 0, frictionCoefficient});
+}
+
+double Heightfield::sweep(Sphere &sphere, const Vec3 &motion)
+{
+    auto start = sphere.getWorldPosition() - getWorldPosition();
+    auto end = start + motion;
+    double startHeight, endHeight;
+    Vec3 startNormal, endNormal;
+    if (!sample(start.x, start.z, startHeight, startNormal))
+        return INFINITY;
+
+    // same as the face of sweepPolygon, with the plane below the end point for the end distance
+    double s0 = (start.y - startHeight) * startNormal.y;
+    double s1 = sample(end.x, end.z, endHeight, endNormal)
+                    ? (end.y - endHeight) * endNormal.y
+                    : s0 + motion.dot(startNormal);
+    // a ball that is all the way under the surface falls on, like behind the face of sweepPolygon
+    if (s0 < -sphere.getRadius() && s1 < -sphere.getRadius())
+        return INFINITY;
+    double sweepRadius = sphere.getRadius() - SWEEP_SLOP;
+    if (s1 >= sweepRadius || s1 >= s0)
+        return INFINITY;
+    return s0 > sweepRadius ? (s0 - sweepRadius) / (s0 - s1) : 0;
+}
+
+AABB Heightfield::getBounds()
+{
+    auto worldPos = getWorldPosition();
+    AABB bounds(worldPos + Vec3(minX, minHeight, minZ),
+                worldPos + Vec3(minX + cellsX * resolution, maxHeight, minZ + cellsZ * resolution));
+    bounds.expand(SimObject::getBounds());
+    return bounds;
+}
@@ -0,0 +1,379 @@
+
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <vector>
+#include <array>
+#include <functional>
+#include <climits>
+#include <math.h>
+
+#include "renderer.hpp"
+#include "vec3.hpp"
+#include "quaternion.hpp"
+
+// Helper functions
+inline double randRange(double min, double max)
+{
+    return min + (max - min) * (double)rand() / RAND_MAX;
+}
+
+constexpr double PI = 3.14159265358979323846;
+
+// Continuous collision
+// a swept ball stops this far inside a contact, so collide() is sure to resolve it
+// balls resting on a surface sink in less than this per step and are not stopped
+constexpr double SWEEP_SLOP = 0.005;
+
+// This is a plane class
+// It is defined by a normal and a point
+class Plane {
+public:
+    Vec3 normal;
+    Vec3 point;
+    Plane(Vec3 normal, Vec3 point);
+    Plane() : normal(0,1,0), point(0,0,0) {}
+    double getDistance(const Vec3& other);
+    Vec3 bounce(const Vec3& v);
+
+};
+
+// An axis aligned bounding box
+// an empty box has min > max and overlaps nothing
+class AABB {
+public:
+    Vec3 min;
+    Vec3 max;
+    AABB() : min(INFINITY), max(-INFINITY) {}
+    AABB(const Vec3& min, const Vec3& max) : min(min), max(max) {}
+    bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+    void expand(const Vec3& p);
+    void expand(const AABB& other);
+    AABB grown(double margin) const { return AABB(min - Vec3(margin), max + Vec3(margin)); }
+    bool overlaps(const AABB& other) const;
+    bool contains(const AABB& other) const;
+    Vec3 getCenter() const { return (min + max) * 0.5; }
+    Vec3 getSize() const { return max - min; }
+};
+
+class Sphere;
+
+// A surface a sphere touches, found by findContacts
+struct Contact {
+    // from the surface to the sphere center
+    Vec3 normal;
+    // how far the sphere has to move along normal to leave the surface
+    double depth;
+    // part of the approach speed the sphere bounces back with, 0 lets it roll along the surface
+    double restitution;
+    // friction coefficient of the surface, slows the sphere along it
+    double friction;
+};
+
+// All contacts of a sphere in one collision check, resolved together
+// resolving them one after the other lets each undo the last, so a ball touching the floor and a wall jitters
+class ContactManifold {
+public:
+    static constexpr size_t maxContacts = 16;
+    static constexpr int solverIterations = 8;
+    // slower approaches do not bounce, so a ball that gravity presses against a surface comes to rest
+    static constexpr double bounceSpeed = 0.2;
+
+    // when full, the shallowest contact is replaced by a deeper one
+    void add(const Contact& contact);
+    size_t size() const { return count; }
+    // sets the velocity and support of the sphere and moves it out of all surfaces, false without contacts
+    bool solve(Sphere& sphere) const;
+
+private:
+    std::array<Contact, maxContacts> contacts;
+    size_t count = 0;
+};
+
+// A simulation object is an abstract class used to represent objects in the simulation
+class SimObject {
+protected:
+    double bounceFactor = 0.99;
+    double frictionCoefficient = 0;
+    Vec3 position;
+    SimObject* parent = nullptr;
+    // world position of the parent, computed lazily by updateWorldTransform
+    Vec3 worldPosition = Vec3(0);
+    // position changed since the world transform was last computed
+    bool transformDirty = true;
+    // counts how often the world transform of this object was recomputed
+    // children compare it with parentGeneration to notice that an ancestor moved
+    unsigned long long transformGeneration = 0;
+    unsigned long long parentGeneration = 0;
+    Vec3 velocity;
+    Vec3 color;
+    double density=1.0;
+    // not owned, whoever creates the children keeps them alive as long as this object (courses use their Arena)
+    std::vector<SimObject*> children;
+
+    // called when the world position of this object changed
+    // used to update cached world space data
+    virtual void onWorldPositionChanged() {}
+
+    // recomputes the cached world position if this object or one of its ancestors moved
+    // moving an object is O(1), the cost is paid by the first read of a world position below it
+    // reads are not synchronized, a course brings moved objects up to date before balls are collided in parallel
+    void updateWorldTransform();
+
+public:
+    SimObject() : position(0), velocity(0), color(1,0,0), density(1) {}
+    SimObject(Vec3 center, double density=1) : position(center), velocity(0), color(1,0,0), density(density) {}
+    virtual ~SimObject() {}
+    void setPosition(Vec3 position);
+    void setDensity(double density) { this->density = density; }
+    void setVelocity(Vec3 velocity) { this->velocity = velocity; }
+    void setColor(Vec3 color) { this->color = color; }
+    Vec3& getPosition() { return position; }
+    Vec3 getWorldPosition() { updateWorldTransform(); return worldPosition + position; }
+    double getDensity() { return density; }
+    Vec3& getVelocity() { return velocity; }
+    Vec3& getColor() { return color; }
+    double getBounceFactor() { return bounceFactor; }
+    void setBounceFactor(double bounceFactor) { this->bounceFactor = bounceFactor; }
+    double calcBounceFactor(const SimObject& other);
+    void addChild(SimObject* child);
+    std::vector<SimObject*>& getChildren() { return children; }
+    // finds the contacts of the sphere with this object and resolves them
+    virtual bool collide(Sphere& sphere);
+    // adds the surfaces of this object and its children that the sphere touches
+    virtual void findContacts(Sphere& sphere, ContactManifold& manifold);
+    // earliest time of impact of the sphere moving by motion, as fraction of motion in [0, 1]
+    // INFINITY if it does not hit this object or its children
+    virtual double sweep(Sphere& sphere, const Vec3& motion);
+
+    virtual void tick(double time);
+    virtual void draw(Renderer& renderer);
+    // draws the children as if this object was at the given local position
+    void drawChildrenAt(Renderer& renderer, const Vec3& position);
+    virtual double getMass() { return static_cast<double>(LLONG_MAX); }
+    // world space bounds of this object and its children
+    virtual AABB getBounds();
+};
+
+// Predefine Sphere class to use in Wall class
+class Sphere;
+
+// World space collision data of a triangle
+// computed once when the triangle is created or moved, so findContacts() does no allocation or setup
+struct BakedTriangle {
+    Vec3 corners[3];
+    Vec3 normal;
+    // normalized edge from corners[i] to corners[(i+1)%3] and its length
+    Vec3 edgeDirections[3];
+    double edgeLengths[3];
+    // barycentric terms with v0 = c - a and v1 = b - a
+    Vec3 v0, v1;
+    double dot00, dot01, dot11;
+    double invDenom;
+};
+
+// World space collision data of a wall
+struct BakedWall {
+    Vec3 corners[4];
+    Vec3 normal;
+    // normalized edge from corners[i] to corners[(i+1)%4] and its length
+    Vec3 edgeDirections[4];
+    double edgeLengths[4];
+    // 2d frame of the wall, v1 and v2 span the rectangle, n is the face normal
+    // trX and trY are the size of the rectangle along v1 and v2
+    Vec3 v1, v2, n;
+    double trX, trY;
+};
+
+// a finite plane defined by three points
+class Triangle : public SimObject {
+protected:
+    Vec3 p1, p2, p3;
+    bool faceCollisionOnly = false;
+    BakedTriangle baked;
+
+    void onWorldPositionChanged();
+
+public:
+    Triangle(const Vec3& p1, const Vec3& p2, const Vec3& p3);
+    Triangle() : Triangle(Vec3(-1,0,-1), Vec3(1,0,-1), Vec3(0,0,1)) {}
+    void draw(Renderer& renderer);
+    void findContacts(Sphere& sphere, ContactManifold& manifold);
+    double sweep(Sphere& sphere, const Vec3& motion);
+    Vec3 getNormal() { return p1.getNormal(p2, p3); }
+    std::array<Vec3, 3> getCorners() { return {p1, p2, p3}; }
+    std::array<Vec3, 3> getWorldCorners();
+    const BakedTriangle& getBaked() { updateWorldTransform(); return baked; }
+    bool isFaceCollisionOnly() { return faceCollisionOnly; }
+    AABB getBounds();
+};
+
+// A wall is defined by four corners
+// acts like a finite plane
+class Wall : public SimObject
+{
+protected:
+    std::array<Vec3, 4> corners;
+    BakedWall baked;
+
+    void onWorldPositionChanged();
+
+public:
+    Wall(const Vec3& corner1, const Vec3& corner2, const Vec3& corner3, const Vec3& corner4);
+    Wall() : Wall(Vec3(-1,0,-1), Vec3(1,0,-1), Vec3(1,0,1), Vec3(-1,0,1)) {}
+    Wall(double x1, double z1, double x2, double z2);
+
+    void draw(Renderer& renderer);
+    double getMass() { return 99999999999.9;}
+    void findContacts(Sphere& sphere, ContactManifold& manifold);
+    double sweep(Sphere& sphere, const Vec3& motion);
+    Vec3 getNormal() { return corners[0].getNormal(corners[1], corners[2]); }
+    const std::array<Vec3, 4>& getCorners() { return corners; }
+    std::array<Vec3, 4> getWorldCorners();
+    const BakedWall& getBaked() { updateWorldTransform(); return baked; }
+    AABB getBounds();
+};
+
+// A flat convex polygon, corners in order around the face
+// collides with its face only, like a ground tile, so a floor merged into one polygon
+// has no edges inside for a rolling ball to catch on
+class ConvexPolygon : public SimObject
+{
+protected:
+    std::vector<Vec3> corners;
+    // world space corners, normalized edge from corners[i] to corners[(i+1)%n] and its length
+    std::vector<Vec3> worldCorners;
+    std::vector<Vec3> edgeDirections;
+    std::vector<double> edgeLengths;
+    Vec3 normal;
+
+    void onWorldPositionChanged();
+
+public:
+    ConvexPolygon(const std::vector<Vec3>& corners);
+
+    void draw(Renderer& renderer);
+    void findContacts(Sphere& sphere, ContactManifold& manifold);
+    double sweep(Sphere& sphere, const Vec3& motion);
+    const std::vector<Vec3>& getCorners() { return corners; }
+    const Vec3& getNormal() { return normal; }
+    AABB getBounds();
+};
+
+// A sphere is defined by a center and a radius
+class Sphere : public SimObject
+{
+protected:
+    double radius;
+    // Steps used to draw the sphere
+    int resolution;
+    // Normal of the floor, used for rolling
+    Vec3 currentFloorNormal = Vec3(0,1,0);
+    // whether surfaces pushed the sphere in the last collision check, the floor normal is then the direction
+    // of their summed push and supportFriction their friction weighted by how hard each pushed
+    bool supported = false;
+    double supportFriction = 0;
+    // rotation from rolling, only used for drawing
+    Quaternion orientation;
+    // sleeping balls are not moved or collided until something wakes them
+    bool sleeping = false;
+    unsigned int slowSteps = 0;
+
+public:
+    // a ball slower than sleepSpeed for sleepSteps steps in a row falls asleep
+    static constexpr double sleepSpeed = 0.01;
+    static constexpr unsigned int sleepSteps = 30;
+
+    Sphere() : SimObject(), radius(1), resolution(10) {}
+    Sphere(Vec3 center, double radius, int resolution=10) : SimObject(center), radius(radius), resolution(resolution) {}
+    void setRadius(double radius) { this->radius = radius; }
+    void setResolution(int resolution) { this->resolution = resolution; }
+    double getRadius() { return radius; }
+    int getResolution() { return resolution; }
+    void setFloorNormal(Vec3 normal) { currentFloorNormal = normal; }
+    Vec3& getFloorNormal() { return currentFloorNormal; }
+    // set by ContactManifold::solve
+    void setSupport(const Vec3& normal, double friction) { currentFloorNormal = normal; supportFriction = friction; supported = true; }
+    void clearSupport() { supported = false; }
+    bool isSupported() { return supported; }
+    double getSupportFriction() { return supportFriction; }
+    const Quaternion& getOrientation() { return orientation; }
+    void setOrientation(const Quaternion& orientation) { this->orientation = orientation; }
+    void draw(Renderer& renderer);
+    void move(Vec3 v);
+    void moveTo(Vec3 v);
+    double getMass();
+    void bounce(Sphere& other);
+    // time of impact with this sphere, uses the same slop as sweep()
+    double sweep(Sphere& sphere, const Vec3& motion);
+    AABB getBounds();
+    bool isSleeping() { return sleeping; }
+    void wake() { sleeping = false; slowSteps = 0; }
+    // call once per step after collisions, puts the ball to sleep when it was slow long enough
+    void updateSleep();
+
+};
+
+// The box in which the simulation takes place
+// It is defined by a vector of walls
+class Box : public SimObject
+{
+protected:
+    std::vector<Wall> walls;
+    size_t outerWallCount = 0;
+
+public:
+    Box() : SimObject() {}
+    Box(const std::vector<double>& xnzn);
+
+
+
+    std::vector<Wall>& getWalls() { return walls; }
+    void draw(Renderer& renderer);
+    double getMass() { return 99999999999.9;}
+    size_t getOuterWallCount() { return outerWallCount; }
+};
+
+// Terrain given by heights sampled on a regular grid in the xz plane
+// every cell is two triangles split along the diagonal from (x, z + 1) to (x + 1, z),
+// only the heights are stored and a ball finds the cell below it in O(1)
+class Heightfield : public SimObject
+{
+protected:
+    double minX, minZ;
+    double resolution;
+    // cells along x and z, there is one more sample than cells in each direction
+    int cellsX, cellsZ;
+    // heights[x * (cellsZ + 1) + z]
+    std::vector<double> heights;
+    double minHeight, maxHeight;
+
+    // mesh for the renderer, built once: xyz per sample and one strip over all cells
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    std::vector<unsigned int> stripIndices;
+    void buildMesh();
+
+    double getHeight(int x, int z) const { return heights[x * (cellsZ + 1) + z]; }
+    // normal at a sample from the slope to its neighbours
+    Vec3 getSampleNormal(int x, int z) const;
+
+public:
+    Heightfield(double minX, double minZ, double maxX, double maxZ, double resolution, const std::function<double(double, double)>& heightFunction);
+    // height and normal of the surface at a local x, z, false outside of the grid
+    bool sample(double x, double z, double& height, Vec3& normal) const;
+
+    void draw(Renderer& renderer);
+    void findContacts(Sphere& sphere, ContactManifold& manifold);
+    double sweep(Sphere& sphere, const Vec3& motion);
+    AABB getBounds();
+
+    const std::vector<float>& getVertices() { return vertices; }
+    const std::vector<float>& getNormals() { return normals; }
+    const std::vector<unsigned int>& getStripIndices() { return stripIndices; }
+};
+
+
+
+
+#endif // SIMULATION_HPP
@@ -0,0 +1,334 @@
+#include "spatialindex.hpp"
+#include <algorithm>
+#include <cstdint>
+
+std::unique_ptr<SpatialIndex> createSpatialIndex(SpatialIndexType type)
+{
+    switch (type)
+    {
+    case SpatialIndexType::GRID:
+        return std::make_unique<UniformGrid>();
+    case SpatialIndexType::BVH:
+        return std::make_unique<BVH>();
+    case SpatialIndexType::LINEAR:
+    default:
+        return std::make_unique<LinearIndex>();
+    }
+}
+
+// sorts the ids and removes duplicates
+static void finishQuery(std::vector<size_t> &result, size_t start)
+{
+    std::sort(result.begin() + start, result.end());
+    result.erase(std::unique(result.begin() + start, result.end()), result.end());
+}
+
+void LinearIndex::build(const std::vector<AABB> &bounds)
+{
+    this->bounds = bounds;
+}
+
+void LinearIndex::query(const AABB &box, std::vector<size_t> &result) const
+{
+    for (size_t i = 0; i < bounds.size(); i++)
+    {
+        if (bounds[i].overlaps(box))
+            result.push_back(i);
+    }
+}
+
+size_t LinearIndex::getMaxQuerySize() const
+{
+    return bounds.size();
+}
+
+void UniformGrid::getCell(const Vec3 &p, int cell[3]) const
+{
+    const double coords[3] = {p.x - gridBounds.min.x, p.y - gridBounds.min.y, p.z - gridBounds.min.z};
+    for (int a = 0; a < 3; a++)
+    {
+        int c = static_cast<int>(std::floor(coords[a] / cellSize));
+        cell[a] = std::clamp(c, 0, dims[a] - 1);
+    }
+}
+
+void UniformGrid::build(const std::vector<AABB> &bounds)
+{
+    this->bounds = bounds;
+    cellStart.clear();
+    items.clear();
+
+    // size of the grid and average size of the objects
+    gridBounds = AABB();
+    double extentSum = 0;
+    size_t count = 0;
+    for (const AABB &b : bounds)
+    {
+        if (b.isEmpty())
+            continue;
+        gridBounds.expand(b);
+        Vec3 size = b.getSize();
+        extentSum += std::max(size.x, std::max(size.y, size.z));
+        count++;
+    }
+
+    if (count == 0)
+    {
+        dims[0] = dims[1] = dims[2] = 0;
+        return;
+    }
+
+    // one cell should hold about one object
+    cellSize = std::max(extentSum / count, 0.01);
+    Vec3 size = gridBounds.getSize();
+    size_t cellCount;
+    while (true)
+    {
+        dims[0] = std::max(1, static_cast<int>(std::ceil(size.x / cellSize)));
+        dims[1] = std::max(1, static_cast<int>(std::ceil(size.y / cellSize)));
+        dims[2] = std::max(1, static_cast<int>(std::ceil(size.z / cellSize)));
+        cellCount = static_cast<size_t>(dims[0]) * dims[1] * dims[2];
+        if (cellCount <= maxCells)
+            break;
+        cellSize *= 1.5;
+    }
+
+    // count objects per cell, then fill
+    cellStart.assign(cellCount + 1, 0);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (size_t i = 0; i < cellCount; i++)
+                cellStart[i + 1] += cellStart[i];
+            items.resize(cellStart[cellCount]);
+        }
+        std::vector<size_t> fill(cellStart.begin(), cellStart.end() - 1);
+
+        for (size_t id = 0; id < bounds.size(); id++)
+        {
+            const AABB &b = bounds[id];
+            if (b.isEmpty())
+                continue;
+            int lo[3], hi[3];
+            getCell(b.min, lo);
+            getCell(b.max, hi);
+            for (int x = lo[0]; x <= hi[0]; x++)
+                for (int y = lo[1]; y <= hi[1]; y++)
+                    for (int z = lo[2]; z <= hi[2]; z++)
+                    {
+                        size_t cell = (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+                        if (pass == 0)
+                            cellStart[cell + 1]++;
+                        else
+                            items[fill[cell]++] = id;
+                    }
+        }
+    }
+}
+
+void UniformGrid::query(const AABB &box, std::vector<size_t> &result) const
+{
+    size_t start = result.size();
+
+    if (dims[0] > 0 && gridBounds.overlaps(box))
+    {
+        int lo[3], hi[3];
+        getCell(box.min, lo);
+        getCell(box.max, hi);
+        for (int x = lo[0]; x <= hi[0]; x++)
+            for (int y = lo[1]; y <= hi[1]; y++)
+                for (int z = lo[2]; z <= hi[2]; z++)
+                {
+                    size_t cell = (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+                    for (size_t i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+                    {
+                        size_t id = items[i];
+                        if (bounds[id].overlaps(box))
+                            result.push_back(id);
+                    }
+                }
+    }
+
+    finishQuery(result, start);
+}
+
+size_t BVH::buildNode(size_t first, size_t count)
+{
+    size_t index = nodes.size();
+    nodes.emplace_back();
+
+    AABB nodeBounds;
+    AABB centers;
+    for (size_t i = first; i < first + count; i++)
+    {
+        nodeBounds.expand(bounds[ids[i]]);
+        centers.expand(bounds[ids[i]].getCenter());
+    }
+    nodes[index].bounds = nodeBounds;
+
+    if (count <= maxLeafSize)
+    {
+        nodes[index].first = first;
+        nodes[index].count = count;
+        return index;
+    }
+
+    // split at the median of the longest axis
+    Vec3 size = centers.getSize();
+    int axis = 0;
+    if (size.y > size.x && size.y >= size.z)
+        axis = 1;
+    else if (size.z > size.x && size.z > size.y)
+        axis = 2;
+
+    auto centerOnAxis = [&](size_t id) {
+        Vec3 c = bounds[id].getCenter();
+        return axis == 0 ? c.x : (axis == 1 ? c.y : c.z);
+    };
+    size_t half = count / 2;
+    std::nth_element(ids.begin() + first, ids.begin() + first + half, ids.begin() + first + count,
+                     [&](size_t a, size_t b) { return centerOnAxis(a) < centerOnAxis(b); });
+
+    size_t left = buildNode(first, half);
+    size_t right = buildNode(first + half, count - half);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+size_t UniformGrid::getMaxQuerySize() const
+{
+    // an object is found once in every cell it overlaps
+    return items.size();
+}
+
+void BVH::build(const std::vector<AABB> &bounds)
+{
+    this->bounds = bounds;
+    nodes.clear();
+    ids.clear();
+
+    for (size_t id = 0; id < bounds.size(); id++)
+    {
+        if (!bounds[id].isEmpty())
+            ids.push_back(id);
+    }
+    if (ids.empty())
+        return;
+
+    nodes.reserve(2 * ids.size() / maxLeafSize + 1);
+    buildNode(0, ids.size());
+}
+
+void BVH::query(const AABB &box, std::vector<size_t> &result) const
+{
+    if (nodes.empty())
+        return;
+
+    size_t start = result.size();
+    size_t stack[64];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node &node = nodes[stack[--stackSize]];
+        if (!node.bounds.overlaps(box))
+            continue;
+
+        if (node.count > 0)
+        {
+            for (size_t i = node.first; i < node.first + node.count; i++)
+            {
+                if (bounds[ids[i]].overlaps(box))
+                    result.push_back(ids[i]);
+            }
+        }
+        else
+        {
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.right;
+        }
+    }
+
+    finishQuery(result, start);
+}
+
+size_t BVH::getMaxQuerySize() const
+{
+    return ids.size();
+}
+
+void SpatialHash::findPairs(const std::vector<AABB> &bounds, std::vector<std::pair<size_t, size_t>> &pairs)
+{
+    size_t start = pairs.size();
+
+    // cells as large as an average box, so most boxes touch at most 8 cells
+    // and at least half as large as the largest box, so no box touches more than 27
+    double extentSum = 0;
+    double maxExtent = 0;
+    size_t count = 0;
+    for (const AABB &b : bounds)
+    {
+        if (b.isEmpty())
+            continue;
+        Vec3 size = b.getSize();
+        double extent = std::max(size.x, std::max(size.y, size.z));
+        extentSum += extent;
+        maxExtent = std::max(maxExtent, extent);
+        count++;
+    }
+    if (count == 0)
+        return;
+    double cellSize = std::max(std::max(extentSum / count, maxExtent / 2), 0.01);
+
+    // 21 bits per axis, coordinates wrap around far away, which only adds tests
+    auto cellCoord = [&](double v) { return static_cast<int64_t>(std::floor(v / cellSize)); };
+    auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+        constexpr uint64_t mask = (1 << 21) - 1;
+        return (static_cast<uint64_t>(x) & mask) | ((static_cast<uint64_t>(y) & mask) << 21) | ((static_cast<uint64_t>(z) & mask) << 42);
+    };
+
+    // room for the most entries the boxes can have, so the buffer only grows with the number of boxes
+    entries.clear();
+    entries.reserve(27 * count);
+    for (size_t id = 0; id < bounds.size(); id++)
+    {
+        const AABB &b = bounds[id];
+        if (b.isEmpty())
+            continue;
+        int64_t lo[3] = {cellCoord(b.min.x), cellCoord(b.min.y), cellCoord(b.min.z)};
+        int64_t hi[3] = {cellCoord(b.max.x), cellCoord(b.max.y), cellCoord(b.max.z)};
+        for (int64_t x = lo[0]; x <= hi[0]; x++)
+            for (int64_t y = lo[1]; y <= hi[1]; y++)
+                for (int64_t z = lo[2]; z <= hi[2]; z++)
+                    entries.push_back({cellKey(x, y, z), id});
+    }
+    std::sort(entries.begin(), entries.end());
+
+    // test the boxes within every cell
+    for (size_t first = 0; first < entries.size();)
+    {
+        size_t end = first + 1;
+        while (end < entries.size() && entries[end].cell == entries[first].cell)
+            end++;
+        for (size_t i = first; i < end; i++)
+        {
+            for (size_t j = i + 1; j < end; j++)
+            {
+                const AABB &a = bounds[entries[i].id];
+                const AABB &b = bounds[entries[j].id];
+                if (!a.overlaps(b))
+                    continue;
+                // boxes that share several cells are only reported from the cell with the lowest corner of their overlap
+                if (cellKey(cellCoord(std::max(a.min.x, b.min.x)), cellCoord(std::max(a.min.y, b.min.y)), cellCoord(std::max(a.min.z, b.min.z))) != entries[i].cell)
+                    continue;
+                pairs.emplace_back(entries[i].id, entries[j].id);
+            }
+        }
+        first = end;
+    }
+
+    std::sort(pairs.begin() + start, pairs.end());
+}
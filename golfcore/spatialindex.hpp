@@ -0,0 +1,121 @@
+#ifndef SPATIALINDEX_HPP
+#define SPATIALINDEX_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "simulation.hpp"
+
+// Acceleration structures used to find the objects near a ball
+// Objects are referenced by id, which is their index in the bounds vector passed to build()
+// an index is built once over objects that do not move, moving objects are kept apart (see Course)
+
+enum class SpatialIndexType
+{
+    LINEAR,
+    GRID,
+    BVH
+};
+
+class SpatialIndex
+{
+public:
+    virtual ~SpatialIndex() {}
+    virtual void build(const std::vector<AABB>& bounds) = 0;
+    // appends ids of all objects that overlap the box
+    // result is sorted and contains every id once
+    virtual void query(const AABB& box, std::vector<size_t>& result) const = 0;
+    // most ids a single query appends before duplicates are removed, callers can reserve this much
+    virtual size_t getMaxQuerySize() const = 0;
+};
+
+// no acceleration, returns every object whose bounds overlap
+class LinearIndex : public SpatialIndex
+{
+private:
+    std::vector<AABB> bounds;
+
+public:
+    void build(const std::vector<AABB>& bounds);
+    void query(const AABB& box, std::vector<size_t>& result) const;
+    size_t getMaxQuerySize() const;
+};
+
+// A uniform grid over the bounds of all objects
+// cells store the ids of all objects that overlap them
+class UniformGrid : public SpatialIndex
+{
+private:
+    AABB gridBounds;
+    double cellSize = 1;
+    int dims[3] = {0, 0, 0};
+    // cell i holds items[cellStart[i]] ... items[cellStart[i+1]-1]
+    std::vector<size_t> cellStart;
+    std::vector<size_t> items;
+    std::vector<AABB> bounds;
+
+    // cell coordinates of p, clamped to the grid
+    void getCell(const Vec3& p, int cell[3]) const;
+
+public:
+    // maximum number of cells, the cell size grows if the scene needs more
+    static constexpr size_t maxCells = 1 << 20;
+
+    void build(const std::vector<AABB>& bounds);
+    void query(const AABB& box, std::vector<size_t>& result) const;
+    size_t getMaxQuerySize() const;
+    double getCellSize() const { return cellSize; }
+};
+
+// A bounding volume hierarchy, split at the median of the longest axis
+class BVH : public SpatialIndex
+{
+private:
+    struct Node
+    {
+        AABB bounds;
+        // inner node: children left and right
+        // leaf: ids[first] ... ids[first+count-1]
+        size_t left = 0;
+        size_t right = 0;
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<size_t> ids;
+    std::vector<AABB> bounds;
+
+    size_t buildNode(size_t first, size_t count);
+
+public:
+    static constexpr size_t maxLeafSize = 4;
+
+    void build(const std::vector<AABB>& bounds);
+    void query(const AABB& box, std::vector<size_t>& result) const;
+    size_t getMaxQuerySize() const;
+};
+
+std::unique_ptr<SpatialIndex> createSpatialIndex(SpatialIndexType type);
+
+// Spatial hash for many moving objects like balls, finds all pairs of overlapping boxes
+// boxes are put into the cells of a uniform grid about the size of an average box,
+// then only boxes that share a cell are tested. Cells are found by sorting (cell, id) entries,
+// so there is no table to size and the result does not depend on hashing.
+class SpatialHash
+{
+private:
+    struct Entry
+    {
+        uint64_t cell;
+        size_t id;
+        bool operator<(const Entry& other) const { return cell < other.cell || (cell == other.cell && id < other.id); }
+    };
+    std::vector<Entry> entries;
+
+public:
+    // appends every pair (a, b) with a < b whose bounds overlap, sorted by a, then b
+    void findPairs(const std::vector<AABB>& bounds, std::vector<std::pair<size_t, size_t>>& pairs);
+};
+
+#endif // SPATIALINDEX_HPP
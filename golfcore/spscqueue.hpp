@@ -0,0 +1,44 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+
+// Lock free ring buffer between one producer thread and one consumer thread
+// holds up to Capacity - 1 items, push fails instead of waiting when it is full
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+private:
+    T items[Capacity];
+    // next item to pop, written by the consumer
+    std::atomic<size_t> head{0};
+    // next free item, written by the producer
+    std::atomic<size_t> tail{0};
+
+public:
+    // producer only
+    bool push(const T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) % Capacity;
+        if (next == head.load(std::memory_order_acquire))
+            return false;
+        items[t] = item;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    bool pop(T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        item = items[h];
+        head.store((h + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif // SPSCQUEUE_HPP
@@ -0,0 +1,129 @@
+#include "threadpool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+{
+    if (workerCount == 0)
+        workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    for (unsigned int i = 0; i <= workerCount; i++)
+        queues.push_back(std::make_unique<Queue>());
+    workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++)
+        workers.emplace_back([this, i] { work(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+void ThreadPool::push(size_t queue, const Task &task)
+{
+    {
+        std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+        queues[queue]->tasks.push_back(task);
+    }
+    queuedTasks++;
+    if (!workers.empty())
+    {
+        // the lock makes sure a worker that is about to sleep sees the new task
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+bool ThreadPool::take(size_t queue, Task &task)
+{
+    {
+        Queue &own = *queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.isEmpty())
+        {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            own.popped();
+            queuedTasks--;
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); i++)
+    {
+        Queue &other = *queues[(queue + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.isEmpty())
+        {
+            task = other.tasks[other.first++];
+            other.popped();
+            queuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t queue, Task task)
+{
+    // leave the upper halves for other threads to steal
+    while (task.end - task.begin > task.job->grain)
+    {
+        size_t middle = task.begin + (task.end - task.begin) / 2;
+        push(queue, {task.job, middle, task.end});
+        task.end = middle;
+    }
+    (*task.job->function)(task.begin, task.end);
+    task.job->remaining -= task.end - task.begin;
+}
+
+void ThreadPool::work(size_t queue)
+{
+    while (true)
+    {
+        Task task;
+        if (take(queue, task))
+        {
+            run(queue, task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return stopping || queuedTasks > 0; });
+        if (stopping)
+            return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &function)
+{
+    if (count == 0)
+        return;
+    grain = std::max<size_t>(grain, 1);
+    if (workers.empty() || count <= grain)
+    {
+        function(0, count);
+        return;
+    }
+
+    Job job;
+    job.function = &function;
+    job.grain = grain;
+    job.remaining = count;
+
+    // the caller splits the whole range, workers steal from it
+    size_t queue = queues.size() - 1;
+    run(queue, {&job, 0, count});
+
+    // help with this or other jobs until this one is done
+    while (job.remaining > 0)
+    {
+        Task task;
+        if (take(queue, task))
+            run(queue, task);
+        else
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// A work stealing thread pool for parallel loops
+// Every thread has its own queue of index ranges. A thread splits a range in halves until it is at most
+// the grain size, keeps working on the first half and leaves the second half in its queue. Idle threads
+// steal the oldest, largest range from the other queues, so uneven work spreads out by itself.
+// The thread calling parallelFor works on the loop too, so several games or evaluators can share a pool.
+class ThreadPool
+{
+private:
+    struct Job
+    {
+        const std::function<void(size_t, size_t)> *function;
+        size_t grain;
+        // indices not processed yet
+        std::atomic<size_t> remaining;
+    };
+
+    struct Task
+    {
+        Job *job;
+        size_t begin;
+        size_t end;
+    };
+
+    // tasks[first] ... tasks.back(), the owner takes from the back and other threads steal from the front
+    // a vector that is reset when it runs empty, unlike a deque it stops allocating once it was deep enough
+    struct Queue
+    {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        size_t first = 0;
+
+        bool isEmpty() { return first == tasks.size(); }
+        void popped()
+        {
+            if (isEmpty())
+            {
+                tasks.clear();
+                first = 0;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    // one queue per worker, the last one is shared by the threads calling parallelFor
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> queuedTasks{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void push(size_t queue, const Task &task);
+    // own queue first (newest task), then the others (oldest task)
+    bool take(size_t queue, Task &task);
+    void run(size_t queue, Task task);
+    void work(size_t queue);
+
+public:
+    // 0 starts one worker less than there are cores, the calling thread is the last one
+    explicit ThreadPool(unsigned int workerCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // calls function(begin, end) on ranges covering [0, count) of at most grain indices and waits for all of them
+    // ranges run in any order and on any thread
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)> &function);
+    // workers plus the calling thread
+    unsigned int getThreadCount() { return static_cast<unsigned int>(workers.size()) + 1; }
+};
+
+#endif // THREADPOOL_HPP
@@ -0,0 +1,45 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <atomic>
+
+// Lock free triple buffer between one writer thread and one reader thread
+// The writer fills the back slot and publishes it, the reader takes the newest published slot.
+// Neither side ever waits for the other and the reader never sees a slot that is being written.
+// Values the reader did not take in time are overwritten, so the writer can run faster than the reader.
+template <typename T>
+class TripleBuffer
+{
+private:
+    static constexpr unsigned int indexMask = 3;
+    // set in middle when it holds a value the reader has not taken yet
+    static constexpr unsigned int freshBit = 4;
+
+    T slots[3];
+    // only used by the writer
+    unsigned int back = 0;
+    // slot passed between writer and reader
+    std::atomic<unsigned int> middle{1};
+    // only used by the reader
+    unsigned int front = 2;
+
+public:
+    // slot the writer fills, keeps its old contents so memory can be reused
+    T &getBack() { return slots[back]; }
+
+    // hands the back slot to the reader and gets a free one in return
+    void publish()
+    {
+        back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // newest published value, it belongs to the reader until the next call
+    T &read()
+    {
+        if (middle.load(std::memory_order_relaxed) & freshBit)
+            front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return slots[front];
+    }
+};
+
+#endif // TRIPLEBUFFER_HPP
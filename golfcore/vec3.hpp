@@ -0,0 +1,130 @@
+#ifndef VEC3_HPP
+#define VEC3_HPP
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GOLF_VEC3F_SSE
+#include <xmmintrin.h>
+#endif
+
+// This is a 3D vector class
+// T is the scalar type, the simulation uses Vec3 (double)
+// Vec3f (float) holds the batch data of the float triangle store, which rounds the baked triangles through it
+template <typename T>
+class Vec3T {
+public:
+    T x, y, z;
+    Vec3T(T x, T y, T z) : x(x), y(y), z(z) {}
+    Vec3T() : x(0), y(0), z(0) {}
+    Vec3T(T xyz) : x(xyz), y(xyz), z(xyz) {}
+    Vec3T(T x, T z) : x(x), y(0), z(z) {}
+    // conversion between scalar types, explicit because it can round
+    template <typename U>
+    explicit Vec3T(const Vec3T<U>& v) : x(static_cast<T>(v.x)), y(static_cast<T>(v.y)), z(static_cast<T>(v.z)) {}
+    Vec3T operator+(const Vec3T& v) const { return Vec3T(x + v.x, y + v.y, z + v.z); }
+    void operator+=(const Vec3T& v) { x += v.x; y += v.y; z += v.z; }
+    Vec3T operator-(const Vec3T& v) const { return Vec3T(x - v.x, y - v.y, z - v.z); }
+    void operator-=(const Vec3T& v) { x -= v.x; y -= v.y; z -= v.z; }
+    Vec3T operator*(T s) const { return Vec3T(x * s, y * s, z * s); }
+    void operator*=(T s) { x *= s; y *= s; z *= s; }
+    Vec3T operator/(T s) const { return Vec3T(x / s, y / s, z / s); }
+    void operator/=(T s) { x /= s; y /= s; z /= s; }
+    Vec3T operator-() const { return Vec3T(-x, -y, -z); }
+    bool operator==(const Vec3T& v) const { return (x==v.x && y==v.y && z==v.z); }
+    // Dot product
+    T dot(const Vec3T& v) const { return x * v.x + y * v.y + z * v.z; }
+    // Cross product
+    Vec3T cross(const Vec3T& v) const { return Vec3T(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x); }
+    T length() const { return std::sqrt(x * x + y * y + z * z); }
+    T lengthSquared() const { return x * x + y * y + z * z; }
+    // Normalize
+    Vec3T normalized() const { return *this / length(); }
+    // Get distance between two points
+    T getDistance(const Vec3T& other) const
+    {
+        return std::sqrt(std::pow(x - other.x, 2) + std::pow(y - other.y, 2) + std::pow(z - other.z, 2));
+    }
+    // Get normal of a plane defined by this location and two directions
+    Vec3T getNormal(const Vec3T& other1, const Vec3T& other2) const
+    {
+        Vec3T v1 = other1 - *this;
+        Vec3T v2 = other2 - *this;
+        return v1.cross(v2).normalized();
+    }
+    friend Vec3T operator*(T s, const Vec3T& v) { return v * s; }
+};
+
+// float vector padded to 16 bytes, so one vector is one SSE register
+// the lanes are rounded like the scalar version, dot adds x, y and z in the same order
+template <>
+class alignas(16) Vec3T<float> {
+public:
+    float x, y, z;
+    // padding, always 0
+    float w = 0;
+    Vec3T(float x, float y, float z) : x(x), y(y), z(z) {}
+    Vec3T() : x(0), y(0), z(0) {}
+    Vec3T(float xyz) : x(xyz), y(xyz), z(xyz) {}
+    Vec3T(float x, float z) : x(x), y(0), z(z) {}
+    template <typename U>
+    explicit Vec3T(const Vec3T<U>& v) : x(static_cast<float>(v.x)), y(static_cast<float>(v.y)), z(static_cast<float>(v.z)) {}
+
+#ifdef GOLF_VEC3F_SSE
+    explicit Vec3T(__m128 v) { _mm_store_ps(&x, v); w = 0; }
+    __m128 load() const { return _mm_load_ps(&x); }
+    Vec3T operator+(const Vec3T& v) const { return Vec3T(_mm_add_ps(load(), v.load())); }
+    Vec3T operator-(const Vec3T& v) const { return Vec3T(_mm_sub_ps(load(), v.load())); }
+    Vec3T operator*(float s) const { return Vec3T(_mm_mul_ps(load(), _mm_set1_ps(s))); }
+    Vec3T operator/(float s) const { return Vec3T(_mm_div_ps(load(), _mm_set1_ps(s))); }
+    float dot(const Vec3T& v) const
+    {
+        __m128 p = _mm_mul_ps(load(), v.load());
+        __m128 xy = _mm_add_ss(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)));
+        return _mm_cvtss_f32(_mm_add_ss(xy, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2))));
+    }
+    Vec3T cross(const Vec3T& v) const
+    {
+        // (y, z, x) * (v.z, v.x, v.y) - (z, x, y) * (v.y, v.z, v.x)
+        __m128 a = load();
+        __m128 b = v.load();
+        __m128 a1 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 b1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+        __m128 a2 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+        __m128 b2 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        return Vec3T(_mm_sub_ps(_mm_mul_ps(a1, b1), _mm_mul_ps(a2, b2)));
+    }
+#else
+    Vec3T operator+(const Vec3T& v) const { return Vec3T(x + v.x, y + v.y, z + v.z); }
+    Vec3T operator-(const Vec3T& v) const { return Vec3T(x - v.x, y - v.y, z - v.z); }
+    Vec3T operator*(float s) const { return Vec3T(x * s, y * s, z * s); }
+    Vec3T operator/(float s) const { return Vec3T(x / s, y / s, z / s); }
+    float dot(const Vec3T& v) const { return x * v.x + y * v.y + z * v.z; }
+    Vec3T cross(const Vec3T& v) const { return Vec3T(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x); }
+#endif
+
+    void operator+=(const Vec3T& v) { *this = *this + v; }
+    void operator-=(const Vec3T& v) { *this = *this - v; }
+    void operator*=(float s) { *this = *this * s; }
+    void operator/=(float s) { *this = *this / s; }
+    Vec3T operator-() const { return Vec3T(-x, -y, -z); }
+    bool operator==(const Vec3T& v) const { return (x==v.x && y==v.y && z==v.z); }
+    float length() const { return std::sqrt(dot(*this)); }
+    float lengthSquared() const { return dot(*this); }
+    Vec3T normalized() const { return *this / length(); }
+    float getDistance(const Vec3T& other) const { return (*this - other).length(); }
+    Vec3T getNormal(const Vec3T& other1, const Vec3T& other2) const
+    {
+        Vec3T v1 = other1 - *this;
+        Vec3T v2 = other2 - *this;
+        return v1.cross(v2).normalized();
+    }
+    // x, y, z as an array, for glVertex3fv and the like
+    const float* data() const { return &x; }
+    friend Vec3T operator*(float s, const Vec3T& v) { return v * s; }
+};
+
+using Vec3 = Vec3T<double>;
+using Vec3f = Vec3T<float>;
+
+#endif // VEC3_HPP
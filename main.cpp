@@ -1,8 +1,16 @@
 #include "mainwindow.h"
 #include <QApplication>
+#include <QSurfaceFormat>
 
 int main(int argc, char *argv[])
 {
+    // the course is drawn with a GLSL 330 shader, the rest still uses the fixed function pipeline
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CompatibilityProfile);
+    format.setDepthBufferSize(24);
+    QSurfaceFormat::setDefaultFormat(format);
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
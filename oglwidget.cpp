@@ -14,84 +14,33 @@ void OGLWidget::runSim()
     constexpr unsigned int fps = 60;
     constexpr double dtime = 1.0 / fps;
     double dt = dtime;
-    constexpr double G = 6.67408e-11;
-    constexpr double planetMass = 5.972e24;
-    constexpr double planetRadius = 6.371e6;
     constexpr int micros = dtime * 1000 * 1000;
     constexpr auto waitTime = std::chrono::microseconds(micros);
     auto lastTime = std::chrono::high_resolution_clock::now();
     unsigned long long frame = 0;
 
 
-    running = true;
     while (running)
     {
         lastTime = std::chrono::high_resolution_clock::now();
         // parama+=0.1;
         dt = dtime * paramb;
-        game.tick(lastTime.time_since_epoch().count());
-        // apply gravity
-        for (golf::Player& player : game.getPlayers())
-        {
-            if(!player.isInGame()) continue;
-            Sphere& sphere = player.getBall();
-            // calculate gravity for planet
-            double mass = sphere.getMass();
-            double force = G * planetMass * mass / pow((sphere.getRadius()) + planetRadius, 2);
-            // apply force
-            double vel = force * dt / mass;
-            //sphere.getVelocity().y -= vel;
-            double radGrav = gravDirection * PI / 180.0;
-            sphere.getVelocity().y -=cos(radGrav) * vel;
-            sphere.getVelocity().x +=sin(radGrav) * vel;
 
-        }
+        // input from the ui thread
+        golf::GameInput input;
+        while (inputs.pop(input))
+            game.applyInput(input);
 
-        // apply velocity
-        for (golf::Player& player : game.getPlayers())
-        {
-            if(!player.isInGame()) continue;
-            Sphere& sphere = player.getBall();
-            auto movement = sphere.getVelocity() * dt;
-            sphere.move(movement);
-        }
+        // tick, gravity, movement and collisions
+        // in deterministic mode the game uses its own clock and a fixed dt
+        game.update(lastTime.time_since_epoch().count(), dt);
 
-        // check collisions
-        std::vector<Sphere *> bouncedSpheres;
-        for (golf::Player& player : game.getPlayers())
-        {
-            if(!player.isInGame()) continue;
-            Sphere& sphere = player.getBall();
-
-            // check collision with golf objects
-            game.collide(sphere);
-
-            // check if already bounced
-            if (std::find(bouncedSpheres.begin(), bouncedSpheres.end(), &sphere) != bouncedSpheres.end())
-                continue;
-
-            for (golf::Player& player : game.getPlayers())
-            {
-                if(!player.isInGame()) continue;
-                Sphere& other = player.getBall();
-
-                // continue if same pointer
-                if (&sphere == &other)
-                    continue;
-                if (sphere.getPosition().getDistance(other.getPosition()) < sphere.getRadius() + other.getRadius())
-                {
-                    sphere.bounce(other);
-
-                    // add to bounced spheres
-                    bouncedSpheres.push_back(&sphere);
-                    bouncedSpheres.push_back(&other);
-                }
-            }
-        }
+        // publish the new state, paintGL draws the newest one without waiting for this thread
+        game.fillSnapshot(snapshots.getBack());
+        snapshots.publish();
 
-
-
-        update();
+        // update() must be called from the ui thread
+        QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
 
         // print update every second
         /*
@@ -117,18 +66,38 @@ OGLWidget::OGLWidget(QWidget *parent)
     paramb = 1;
     paramc = 1;
     lightDirection = 0;
+    updateCamera();
 
 }
 
 void OGLWidget::startSim()
 {
-    std::thread thr([&]
-                    { this->runSim(); });
-    thr.detach();
+    if (running)
+        return;
+    // a stopped sim thread finishes its last step before a new one starts
+    if (simThread.joinable())
+        simThread.join();
+    running = true;
+    simThread = std::thread([this]
+                            { this->runSim(); });
 }
 
 OGLWidget::~OGLWidget()
 {
+    running = false;
+    if (simThread.joinable())
+        simThread.join();
+
+    // the course buffers belong to the context of this widget
+    makeCurrent();
+    renderer.releaseGL();
+    doneCurrent();
+}
+
+void OGLWidget::setGravity(int i)
+{
+    gravDirection = i;
+    inputs.push({golf::GameInput::Type::SET_GRAVITY, Vec3(0), i});
 }
 
 void OGLWidget::setUi(Ui::MainWindow *ui)
@@ -151,6 +120,8 @@ void OGLWidget::initializeGL()
     glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
     glEnable(GL_COLOR_MATERIAL);
 
+    renderer.initialize();
+
     this->startSim();
 }
 
@@ -184,27 +155,18 @@ void OGLWidget::paintGL()
 {
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(projectionMatrix.constData());
     glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-
-
-
+    glLoadMatrixf(viewMatrix.constData());
 
     glPushMatrix();
 
-    // rotate with gravity
-    //glRotatef(gravDirection, 0, 0, 1);
-    QMatrix4x4 qViewMatrix;
-    glRotatef(-45, 1, 0, 0);
-    qViewMatrix.rotate(-45, 1, 0, 0);
-    glRotatef(-135, 0, 1, 0);
-    qViewMatrix.rotate(-135, 0, 1, 0);
-    glScaled(0.1, 0.1, 0.1);
-    qViewMatrix.scale(0.1, 0.1, 0.1);
-
     float lightRot = parama * 36;
+    QMatrix4x4 lightMatrix = viewMatrix;
+    lightMatrix.rotate(lightRot, 0, 0, 1);
     glPushMatrix();
-    glRotatef(lightRot, 0, 0, 1);
+    glLoadMatrixf(lightMatrix.constData());
 
     // light at 0/0/10
     float light_position[] = {10, 5, -10, 0};
@@ -212,6 +174,10 @@ void OGLWidget::paintGL()
     glEnable(GL_LIGHT1);
     glPopMatrix();
 
+    // the same light and matrices for the shaders
+    QVector3D lightDirectionEye = (lightMatrix * QVector4D(light_position[0], light_position[1], light_position[2], light_position[3])).toVector3D().normalized();
+    renderer.setCamera(projectionMatrix, viewMatrix, lightDirectionEye);
+
 
     if(OGLWidget::showAxis) {
         
@@ -231,50 +197,8 @@ void OGLWidget::paintGL()
         glEnd();
     }
 
-    game.draw();
-
-    glPushMatrix();
-
-
-    glGetIntegerv(GL_VIEWPORT, viewport);
-
-    GLfloat normalizedX = (2.0f * lastMousePos.x - viewport[0]) / viewport[2] - 1.0f;
-    GLfloat normalizedY = 1.0f - (4.0f *lastMousePos.y - viewport[1]) / viewport[3];
-
-    
-    //GLfloat modelViewMatrix[16];
-    GLfloat projectionMatrixData[16];
-
-    glGetFloatv(GL_PROJECTION_MATRIX, projectionMatrixData);
-
-    for(int i = 0; i < 16; i++) {
-        projectionMatrix.data()[i] = projectionMatrixData[i];
-    }
-
-
-
-    // Get the current OpenGL model-view matrix
-    GLfloat modelViewMatrixData[16];
-    glGetFloatv(GL_MODELVIEW_MATRIX, modelViewMatrixData);
-    for(int i = 0; i < 16; i++) {
-        modelViewMatrix.data()[i] = modelViewMatrixData[i];
-    }
-
-    Vec3 worldMouse = screenToWorld(lastMousePos.x, lastMousePos.y);
-
-    
-    /*
-    Sphere s;
-    s.setRadius(0.2);
-    s.setPosition(worldMouse);
-    s.draw();
-    */
-    
-    glPopMatrix();
-    
-
-
-
+    snapshots.read().draw(renderer);
+    renderer.flushSpheres();
 
     glPopMatrix();
 
@@ -282,6 +206,23 @@ void OGLWidget::paintGL()
     
 }
 
+void OGLWidget::updateCamera()
+{
+    // rotate with gravity
+    //viewMatrix.rotate(gravDirection, 0, 0, 1);
+    viewMatrix.setToIdentity();
+    viewMatrix.rotate(-45, 1, 0, 0);
+    viewMatrix.rotate(-135, 0, 1, 0);
+    viewMatrix.scale(0.1, 0.1, 0.1);
+
+    // the scene is drawn without a projection
+    projectionMatrix.setToIdentity();
+
+    // inverted here instead of on every mouse move
+    inverseProjectionMatrix = projectionMatrix.inverted();
+    inverseViewMatrix = viewMatrix.inverted();
+}
+
 Vec3 OGLWidget::screenToWorld(int x, int y) {
 
 
@@ -289,16 +230,14 @@ Vec3 OGLWidget::screenToWorld(int x, int y) {
     GLfloat normalizedY = 1.0f - (4.0f *y - viewport[1]) / viewport[3];
 
     
-    QMatrix4x4 projectionMatrixInverse = projectionMatrix.inverted();
     QVector4D rayClip(normalizedX, normalizedY, 1.0f, 1.0f);
-    QVector4D rayView = projectionMatrixInverse * rayClip;
+    QVector4D rayView = inverseProjectionMatrix * rayClip;
     
     double w = rayView.w();
     QVector3D rayView3D(rayView.x() / w, rayView.y() / w, rayView.z() / w);
 
     // Transform the ray to world space
-    QMatrix4x4 modelViewMatrixInverse = modelViewMatrix.inverted();
-    QVector4D rayWorld = modelViewMatrixInverse * QVector4D(rayView3D, 1.0f);
+    QVector4D rayWorld = inverseViewMatrix * QVector4D(rayView3D, 1.0f);
 
     return Vec3(rayWorld.x(), 0, rayWorld.z());
 
@@ -310,6 +249,9 @@ bool OGLWidget::showAxis = false;
 void OGLWidget::resizeGL(int w, int h)
 {
     glViewport(0, 0, w, h);
+    // in the same units as the mouse events
+    viewport[2] = w;
+    viewport[3] = h;
     woh = static_cast<double>(w) / static_cast<double>(h);
     glMatrixMode(GL_PROJECTION);
     /*glLoadIdentity();
@@ -335,7 +277,7 @@ void OGLWidget::mousePressEvent(QMouseEvent *event)
 void OGLWidget::mouseReleaseEvent(QMouseEvent *event) {
     // something
     //std::cout << " Release " << std::endl;
-    game.getController().releaseMouse();
+    inputs.push({golf::GameInput::Type::RELEASE_MOUSE, Vec3(0), 0});
 
 }
 
@@ -354,7 +296,7 @@ void OGLWidget::mouseMoveEvent(QMouseEvent *event)
 
     Vec3 worldPos = screenToWorld(event->x(), event->y());
     //std::cout << " X: " << worldPos.x << ", Z: " << worldPos.z << std::endl;
-    game.getController().holdMouse(worldPos);
+    inputs.push({golf::GameInput::Type::HOLD_MOUSE, worldPos, 0});
 
  ;
 
@@ -369,6 +311,13 @@ void OGLWidget::keyPressEvent(QKeyEvent *event)
         case Qt::Key_Up:
             break;
 
+        // D: toggle deterministic simulation
+        case Qt::Key_D:
+            deterministic = !deterministic;
+            inputs.push({golf::GameInput::Type::SET_DETERMINISTIC, Vec3(0), deterministic});
+            std::cout << "Deterministic: " << deterministic << std::endl;
+            break;
+
         // All other will be ignored
         default:
             break;
@@ -1,10 +1,18 @@
 #ifndef OGLWIDGET_H
 #define OGLWIDGET_H
 
+#include <QOpenGLWidget>
+#include <QOpenGLFunctions>
+
 #include "simulation.hpp"
 #include "minigolf.hpp"
+#include "glrenderer.h"
+#include "triplebuffer.hpp"
+#include "spscqueue.hpp"
 
 #include <QMouseEvent>
+#include <atomic>
+#include <thread>
 
 namespace Ui {
 class MainWindow;
@@ -37,24 +45,38 @@ public slots:
     void stopSim() { running = false; }
     void startSim();
     void toggleAxis() { showAxis = !showAxis; }
-    void setGravity(int i) { gravDirection = i;}
+    void setGravity(int i);
 
 protected:
     void initializeGL();
     void resizeGL(int w, int h);
     void paintGL();
     void runSim();
-    bool running = false;
+    std::atomic<bool> running{false};
+    std::thread simThread;
+    // only used by the sim thread, the ui thread talks to it through snapshots and inputs
     golf::Game game;
+    // newest state of the game for paintGL, written by the sim thread
+    TripleBuffer<golf::RenderSnapshot> snapshots;
+    // mouse and key input for the sim thread, written by the ui thread
+    SpscQueue<golf::GameInput, 256> inputs;
+    bool deterministic = false;
+    GLRenderer renderer;
     void setSphereRadius(int idx, int value);
     Vec3 screenToWorld(int x, int y);
+    // camera, kept on the cpu so nothing is read back from OpenGL
+    // updateCamera sets the matrices and the inverses used by screenToWorld, call it when the camera or viewport changes
+    void updateCamera();
     QMatrix4x4 projectionMatrix;
-    QMatrix4x4 modelViewMatrix;
-    GLint viewport[4];
+    QMatrix4x4 viewMatrix;
+    QMatrix4x4 inverseProjectionMatrix;
+    QMatrix4x4 inverseViewMatrix;
+    int viewport[4] = {0, 0, 1, 1};
 
 protected:
     double parama;
-    double paramb;
+    // simulation speed, read by the sim thread
+    std::atomic<double> paramb;
     double paramc;
     int gravDirection = 0;
     int lightDirection;
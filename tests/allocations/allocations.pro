@@ -0,0 +1,7 @@
+TARGET = tst_allocations
+include(../test.pri)
+
+# the counting operator new is compiled into the test, golfcore itself need not be built with count_allocations
+DEFINES += GOLF_COUNT_ALLOCATIONS
+SOURCES += tst_allocations.cpp \
+           $$PWD/../../golfcore/allocationcounter.cpp
@@ -0,0 +1,94 @@
+#include "check.hpp"
+#include "allocationcounter.hpp"
+#include "minigolf.hpp"
+#include "threadpool.hpp"
+#include <new>
+
+// Checks that Game::update does not allocate once a level is loaded and the balls are rolling.
+
+using namespace golf;
+
+struct alignas(64) AlignedBlock
+{
+    char data[64];
+};
+
+// kept in a volatile, so the compiler cannot leave out a new and delete pair
+static void *volatile lastAllocation;
+
+// every form of operator new must be counted, or an allocation in a tick could go unnoticed
+static void testCountedForms()
+{
+    unsigned long long before = getAllocationCount();
+    int *single = new int(1);
+    lastAllocation = single;
+    delete single;
+    int *array = new int[4];
+    lastAllocation = array;
+    delete[] array;
+    int *nothrowSingle = new (std::nothrow) int(2);
+    lastAllocation = nothrowSingle;
+    delete nothrowSingle;
+    int *nothrowArray = new (std::nothrow) int[4];
+    lastAllocation = nothrowArray;
+    delete[] nothrowArray;
+    AlignedBlock *aligned = new AlignedBlock;
+    lastAllocation = aligned;
+    delete aligned;
+    AlignedBlock *alignedArray = new AlignedBlock[2];
+    lastAllocation = alignedArray;
+    delete[] alignedArray;
+    AlignedBlock *nothrowAligned = new (std::nothrow) AlignedBlock;
+    lastAllocation = nothrowAligned;
+    delete nothrowAligned;
+    CHECK(getAllocationCount() - before == 7);
+}
+
+// one soft shot per player, through the controller like a player, so the balls roll without reaching the hole
+static void shootSoftly(Game &game)
+{
+    if (game.getShotState() != ShotState::AIMING || game.getCurrentPlayer() < 0)
+        return;
+    Vec3 position = game.getPlayers()[game.getCurrentPlayer()].getBall().getPosition();
+    position.y = 0;
+    game.getController().holdMouse(position);
+    game.getController().holdMouse(position + Vec3(0.3, 0, 0.1));
+    game.getController().releaseMouse();
+}
+
+int main()
+{
+    CHECK(isCountingAllocations());
+    testCountedForms();
+
+    ThreadPool pool(3);
+    Game game;
+    game.setDeterministic(true);
+    game.setThreadPool(pool.getThreadCount() > 1 ? &pool : nullptr);
+
+    // warm up: load the level and let both players shoot, the step buffers grow once both balls are in play
+    for (int i = 0; i < 600 && game.getShotLog().size() < 2; i++)
+    {
+        shootSoftly(game);
+        game.update(0, Game::fixedDt);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        game.update(0, Game::fixedDt);
+    }
+    size_t shots = game.getShotLog().size();
+    CHECK(shots == 2);
+
+    unsigned long long before = getAllocationCount();
+    for (int i = 0; i < 2000; i++)
+    {
+        game.update(0, Game::fixedDt);
+    }
+    unsigned long long allocations = getAllocationCount() - before;
+    std::cout << allocations << " allocations in 2000 updates" << std::endl;
+    CHECK(allocations == 0);
+    // no new shot or level was started in between, they may allocate
+    CHECK(game.getShotLog().size() == shots);
+
+    return checkResult();
+}
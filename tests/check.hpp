@@ -0,0 +1,39 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+// Minimal checks for the golfcore tests, golfcore does not link against a test framework
+// CHECK prints failed conditions and goes on, main returns checkResult()
+
+inline int &checkFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline bool check(bool condition, const char *text, const char *file, int line)
+{
+    if (!condition)
+    {
+        std::cout << file << ":" << line << ": check failed: " << text << std::endl;
+        checkFailures()++;
+    }
+    return condition;
+}
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+// 0 if every check passed, prints a summary
+inline int checkResult()
+{
+    if (checkFailures() == 0)
+    {
+        std::cout << "all checks passed" << std::endl;
+        return 0;
+    }
+    std::cout << checkFailures() << " checks failed" << std::endl;
+    return 1;
+}
+
+#endif // CHECK_HPP
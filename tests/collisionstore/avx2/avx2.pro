@@ -0,0 +1,6 @@
+TARGET = tst_collisionstore_avx2
+include(../collisionstore.pri)
+
+# the test skips itself on processors without AVX2
+gcc|clang: QMAKE_CXXFLAGS += -mavx2
+msvc: QMAKE_CXXFLAGS += /arch:AVX2
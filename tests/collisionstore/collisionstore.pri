@@ -0,0 +1,7 @@
+# the triangle store test, built once per kernel
+# collisionstore.cpp is compiled into the test with the flags of the kernel, the rest comes from golfcore
+
+include(../test.pri)
+
+SOURCES += $$PWD/tst_collisionstore.cpp \
+           $$PWD/../../golfcore/collisionstore.cpp
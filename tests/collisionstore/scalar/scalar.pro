@@ -0,0 +1,4 @@
+TARGET = tst_collisionstore_scalar
+include(../collisionstore.pri)
+
+DEFINES += GOLF_NO_SIMD
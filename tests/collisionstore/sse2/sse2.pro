@@ -0,0 +1,4 @@
+TARGET = tst_collisionstore_sse2
+include(../collisionstore.pri)
+
+# SSE2 is the default kernel on x86
@@ -0,0 +1,194 @@
+#include "check.hpp"
+#include "collisionstore.hpp"
+#include "minigolf.hpp"
+#include <memory>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+// Compares the triangle store of this build's kernel with calling Triangle::findContacts on every triangle.
+// Both stores must lead Course::findContacts to exactly the triangles that give contacts,
+// and a course of loose triangles must collide balls through the store exactly like without it.
+
+#if defined(GOLF_NO_SIMD)
+static const char *expectedKernel = "scalar";
+#elif defined(__AVX2__)
+static const char *expectedKernel = "avx2";
+#else
+static const char *expectedKernel = "sse2";
+#endif
+
+static double randomBetween(std::mt19937 &generator, double from, double to)
+{
+    return std::uniform_real_distribution<double>(from, to)(generator);
+}
+
+static Vec3 randomPoint(std::mt19937 &generator, double size)
+{
+    return Vec3(randomBetween(generator, -size, size), randomBetween(generator, -size, size), randomBetween(generator, -size, size));
+}
+
+// triangles that give contacts with the sphere, in the order of slots, one findContacts call per triangle
+static std::vector<size_t> findContactsDirectly(std::vector<std::unique_ptr<Triangle>> &triangles, Sphere &sphere, const std::vector<size_t> &slots)
+{
+    std::vector<size_t> result;
+    for (size_t slot : slots)
+    {
+        ContactManifold manifold;
+        triangles[slot]->findContacts(sphere, manifold);
+        if (manifold.size() > 0)
+            result.push_back(slot);
+    }
+    return result;
+}
+
+// the same, but only the triangles the store reports are tested, like Course::findContacts
+template <typename Store>
+static std::vector<size_t> findContactsWithStore(const Store &store, Sphere &sphere, const std::vector<size_t> &slots)
+{
+    std::vector<size_t> result;
+    size_t i = 0;
+    while (i < slots.size())
+    {
+        size_t hit = store.findFirstHit(sphere.getWorldPosition(), sphere.getRadius(), slots.data() + i, slots.size() - i);
+        if (hit == slots.size() - i)
+            break;
+        i += hit;
+        size_t slot = slots[i];
+        ContactManifold manifold;
+        store.getTriangle(slot)->findContacts(sphere, manifold);
+        if (manifold.size() > 0)
+            result.push_back(slot);
+        i++;
+    }
+    return result;
+}
+
+template <typename Store>
+static void testStore(const char *name)
+{
+    std::mt19937 generator(12345);
+    size_t contacts = 0;
+    size_t mismatches = 0;
+    for (int trial = 0; trial < 3000; trial++)
+    {
+        std::vector<std::unique_ptr<Triangle>> triangles;
+        size_t count = 1 + generator() % 40;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (generator() % 2 == 0)
+            {
+                // ground like tiles around y = 0, tested face only
+                Vec3 base = randomPoint(generator, 1);
+                base.y = randomBetween(generator, -0.05, 0.05);
+                triangles.push_back(std::make_unique<golf::GroundTile>(base, base + Vec3(randomBetween(generator, 0.1, 0.8), 0, randomBetween(generator, -0.2, 0.2)),
+                                                                       base + Vec3(randomBetween(generator, -0.2, 0.2), 0, randomBetween(generator, 0.1, 0.8))));
+            }
+            else
+            {
+                Vec3 a = randomPoint(generator, 1);
+                triangles.push_back(std::make_unique<Triangle>(a, a + randomPoint(generator, 0.6), a + randomPoint(generator, 0.6)));
+            }
+        }
+
+        Store store;
+        for (auto &triangle : triangles)
+            store.add(*triangle);
+
+        // a random subset in random order, like the slots of a spatial query
+        std::vector<size_t> slots;
+        for (size_t i = 0; i < count; i++)
+            slots.push_back(i);
+        std::shuffle(slots.begin(), slots.end(), generator);
+        slots.resize(1 + generator() % count);
+        if (generator() % 2 == 0)
+            std::sort(slots.begin(), slots.end());
+
+        Sphere sphere(randomPoint(generator, 1.2), randomBetween(generator, 0.05, 0.5));
+        std::vector<size_t> expected = findContactsDirectly(triangles, sphere, slots);
+        std::vector<size_t> actual = findContactsWithStore(store, sphere, slots);
+        contacts += expected.size();
+        if (expected != actual)
+            mismatches++;
+    }
+
+    std::cout << name << ": " << contacts << " contacts, " << mismatches << " trials differ" << std::endl;
+    CHECK(mismatches == 0);
+    // the random scenes must actually hit something
+    CHECK(contacts > 400);
+}
+
+// a course of loose static triangles
+// the shipped courses have none, their floors are merged into polygons or heightfields,
+// so this is the only place where Course::findContacts goes through the triangle store
+class TriangleCourse : public golf::Course
+{
+public:
+    TriangleCourse(golf::Game &game, std::mt19937 &generator) : Course(game, Vec3(0, 0, 100), Vec3(0, 0, 0))
+    {
+        for (int i = 0; i < 200; i++)
+        {
+            Vec3 a = randomPoint(generator, 3);
+            addChild(arena.create<Triangle>(a, a + randomPoint(generator, 0.6), a + randomPoint(generator, 0.6)));
+        }
+    }
+
+    size_t getStoredTriangleCount() const
+    {
+        return storeSlots.size() - std::count(storeSlots.begin(), storeSlots.end(), SIZE_MAX);
+    }
+};
+
+// a course with the store must move a ball exactly like one that calls findContacts on every child
+static void testCourse(CollisionPrecision precision, const char *name)
+{
+    golf::Game game;
+    std::mt19937 generator(6789);
+    TriangleCourse indexed(game, generator);
+    generator.seed(6789);
+    TriangleCourse plain(game, generator);
+    indexed.buildIndex(SpatialIndexType::GRID, precision);
+    CHECK(indexed.getStoredTriangleCount() == 200);
+
+    size_t collisions = 0;
+    size_t mismatches = 0;
+    for (int trial = 0; trial < 3000; trial++)
+    {
+        Sphere a(randomPoint(generator, 3), randomBetween(generator, 0.05, 0.3));
+        a.setVelocity(randomPoint(generator, 1));
+        Sphere b = a;
+        bool collided = indexed.collide(a);
+        if (collided != plain.collide(b))
+            mismatches++;
+        else if (!(a.getPosition() == b.getPosition()) || !(a.getVelocity() == b.getVelocity()))
+            mismatches++;
+        if (collided)
+            collisions++;
+    }
+
+    std::cout << name << " course: " << collisions << " collisions, " << mismatches << " balls differ" << std::endl;
+    CHECK(mismatches == 0);
+    CHECK(collisions > 200);
+}
+
+int main()
+{
+#if defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        std::cout << "no AVX2 on this processor, skipped" << std::endl;
+        return 0;
+    }
+#endif
+
+    std::cout << "kernel " << TriangleStore::getKernelName() << std::endl;
+    CHECK(std::strcmp(TriangleStore::getKernelName(), expectedKernel) == 0);
+
+    testStore<TriangleStore>("double store");
+    testStore<FloatTriangleStore>("float store");
+    testCourse(CollisionPrecision::DOUBLE, "double");
+    testCourse(CollisionPrecision::FLOAT, "float");
+    return checkResult();
+}
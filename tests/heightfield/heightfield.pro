@@ -0,0 +1,4 @@
+TARGET = tst_heightfield
+include(../test.pri)
+
+SOURCES += tst_heightfield.cpp
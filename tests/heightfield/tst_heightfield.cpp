@@ -0,0 +1,42 @@
+#include "check.hpp"
+#include "minigolf.hpp"
+#include "shotevaluator.hpp"
+
+// Checks that the heightfield floor is one-sided in depth: a ball deep below the surface
+// is neither pushed up nor stopped by it, it falls out of bounds.
+
+using namespace golf;
+
+// a ball that ended up under the terrain and is falling fast
+static void testFallBelowSurface()
+{
+    Game game;
+    Course4 course(game);
+    course.buildIndex(SpatialIndexType::GRID);
+
+    ShotResult result = ShotEvaluator::simulate(course, Vec3(-1, -0.3, -1), Vec3(0, -20, 0));
+    std::cout << "below the surface: outcome " << static_cast<int>(result.outcome) << " after " << result.ticks << " ticks at y "
+              << result.finalPosition.y << std::endl;
+    CHECK(result.outcome == ShotOutcome::OUT_OF_BOUNDS);
+    CHECK(result.finalPosition.y < Course::outOfBoundsHeight);
+}
+
+// a ball dropped from above still lands on the terrain and stays there
+static void testDropOnSurface()
+{
+    Game game;
+    Course4 course(game);
+    course.buildIndex(SpatialIndexType::GRID);
+
+    ShotResult result = ShotEvaluator::simulate(course, Vec3(-1, 1, -1), Vec3(0, -20, 0));
+    std::cout << "above the surface: outcome " << static_cast<int>(result.outcome) << " after " << result.ticks << " ticks" << std::endl;
+    CHECK(result.outcome != ShotOutcome::OUT_OF_BOUNDS);
+    CHECK(result.finalPosition.y > Course::outOfBoundsHeight);
+}
+
+int main()
+{
+    testFallBelowSurface();
+    testDropOnSurface();
+    return checkResult();
+}
@@ -0,0 +1,4 @@
+TARGET = tst_parallelballs
+include(../test.pri)
+
+SOURCES += tst_parallelballs.cpp
@@ -0,0 +1,110 @@
+#include "check.hpp"
+#include "minigolf.hpp"
+#include "threadpool.hpp"
+#include <cstdint>
+#include <random>
+
+// Steps enough balls for Game::forEachBall to split them between the threads of the pool,
+// and checks that every step hashes the same as on one thread.
+
+using namespace golf;
+
+static constexpr int steps = 600;
+
+// 96 balls in three layers over the first course, the upper layers fall onto the lower ones
+// some roll into their neighbours and some stay apart, so there are isolated and connected balls
+static void addBalls(Game &game)
+{
+    std::mt19937 generator(2024);
+    std::uniform_real_distribution<double> speed(-1, 1);
+    std::vector<Player> &players = game.getPlayers();
+    players.clear();
+    for (int layer = 0; layer < 3; layer++)
+        for (int x = 0; x < 4; x++)
+            for (int z = 0; z < 8; z++)
+            {
+                Player player("ball");
+                player.startHole();
+                player.getBall().setPosition(Vec3(-1.5 + x, 0.5 + 1.5 * layer, -1.5 + z));
+                player.getBall().setVelocity(Vec3(speed(generator), 0, speed(generator)));
+                players.push_back(player);
+            }
+}
+
+// moving balls that can reach another ball in the next step and moving balls that cannot,
+// with the same rule as the bounds Game::step sorts them by, widened a bit for gravity
+static void countNeighbours(Game &game, size_t &connected, size_t &isolated)
+{
+    std::vector<Player> &players = game.getPlayers();
+    connected = 0;
+    isolated = 0;
+    for (size_t i = 0; i < players.size(); i++)
+    {
+        Sphere &ball = players[i].getBall();
+        if (ball.isSleeping())
+            continue;
+        bool reaches = false;
+        for (size_t j = 0; j < players.size() && !reaches; j++)
+        {
+            Sphere &other = players[j].getBall();
+            double reach = ball.getRadius() + other.getRadius() + (ball.getVelocity().length() + other.getVelocity().length() + 1) * Game::fixedDt;
+            reaches = i != j && ball.getPosition().getDistance(other.getPosition()) < reach;
+        }
+        if (reaches)
+            connected++;
+        else
+            isolated++;
+    }
+}
+
+static std::vector<uint64_t> run(ThreadPool *pool, size_t &maxConnected, size_t &maxIsolated)
+{
+    Game game;
+    game.setThreadPool(pool);
+    addBalls(game);
+    std::vector<uint64_t> hashes;
+    maxConnected = 0;
+    maxIsolated = 0;
+    for (int i = 0; i < steps; i++)
+    {
+        game.step(Game::fixedDt);
+        hashes.push_back(game.getStateHash());
+        size_t connected, isolated;
+        countNeighbours(game, connected, isolated);
+        maxConnected = std::max(maxConnected, connected);
+        maxIsolated = std::max(maxIsolated, isolated);
+    }
+    return hashes;
+}
+
+int main()
+{
+    ThreadPool pool(3);
+
+    size_t connected, isolated;
+    std::vector<uint64_t> serial = run(nullptr, connected, isolated);
+    std::cout << "at most " << connected << " connected and " << isolated << " isolated balls in a step" << std::endl;
+    // both loops over balls must have been long enough for the pool, in several ranges
+    CHECK(connected >= Game::parallelBallCount);
+    CHECK(isolated >= Game::parallelBallCount);
+    CHECK(Game::parallelBallCount > Game::ballGrain);
+
+    // the pool splits the balls between threads, results must not depend on it
+    for (int repeat = 0; repeat < 3; repeat++)
+    {
+        size_t connectedOnPool, isolatedOnPool;
+        std::vector<uint64_t> parallel = run(&pool, connectedOnPool, isolatedOnPool);
+        size_t differences = 0;
+        for (size_t i = 0; i < serial.size(); i++)
+        {
+            if (serial[i] != parallel[i])
+                differences++;
+        }
+        std::cout << "pool run " << repeat << ": " << differences << " steps differ, final hash " << std::hex << parallel.back() << std::dec
+                  << std::endl;
+        CHECK(parallel.size() == serial.size());
+        CHECK(differences == 0);
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,4 @@
+TARGET = tst_replay
+include(../test.pri)
+
+SOURCES += tst_replay.cpp
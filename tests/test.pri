@@ -0,0 +1,27 @@
+# common settings of the golfcore tests
+# every test is a console program that returns 0 if all its checks pass
+
+TEMPLATE = app
+CONFIG  += console c++17 thread testcase
+CONFIG  -= qt app_bundle
+
+# same floating point rules as golfcore, results are compared bit for bit
+gcc|clang: QMAKE_CXXFLAGS += -ffp-contract=off
+
+INCLUDEPATH += $$PWD $$PWD/../golfcore
+DEPENDPATH  += $$PWD/../golfcore
+
+# build directory of golfcore, next to the one of the tests
+GOLFCORE_OUT = $$shadowed($$PWD/../golfcore)
+
+win32:CONFIG(release, debug|release): LIBS += -L$$GOLFCORE_OUT/release/ -lgolfcore
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$GOLFCORE_OUT/debug/ -lgolfcore
+else:unix: LIBS += -L$$GOLFCORE_OUT/ -lgolfcore
+
+win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$GOLFCORE_OUT/release/libgolfcore.a
+else:win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$GOLFCORE_OUT/debug/libgolfcore.a
+else:win32:!win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$GOLFCORE_OUT/release/golfcore.lib
+else:win32:!win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$GOLFCORE_OUT/debug/golfcore.lib
+else:unix: PRE_TARGETDEPS += $$GOLFCORE_OUT/libgolfcore.a
+
+HEADERS += $$PWD/check.hpp
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Headless tests of golfcore, run with make check
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += allocations \
+           collisionstore/scalar \
+           collisionstore/sse2 \
+           collisionstore/avx2 \
+           heightfield \
+           parallelballs \
+           replay \
+           vec3
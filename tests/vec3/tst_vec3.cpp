@@ -0,0 +1,79 @@
+#include "check.hpp"
+#include "vec3.hpp"
+#include <random>
+
+// Checks the float specialization of Vec3T against the double version:
+// every operation must give the double result of the same inputs, rounded to float after every step,
+// which is what the scalar float code gives. With SSE the lanes are computed by the intrinsics.
+
+#if defined(GOLF_VEC3F_SSE)
+static const char *path = "sse";
+#else
+static const char *path = "scalar";
+#endif
+
+static float rounded(double value)
+{
+    return static_cast<float>(value);
+}
+
+static bool same(const Vec3f &a, const Vec3f &b)
+{
+    return a == b && a.w == 0 && b.w == 0;
+}
+
+int main()
+{
+    std::cout << "Vec3f uses the " << path << " path" << std::endl;
+    CHECK(sizeof(Vec3f) == 16);
+    CHECK(alignof(Vec3f) == 16);
+
+    std::mt19937 generator(4711);
+    std::uniform_real_distribution<float> coordinate(-100, 100);
+    std::uniform_real_distribution<float> divisor(0.01f, 50);
+    size_t mismatches = 0;
+    for (int trial = 0; trial < 100000; trial++)
+    {
+        Vec3f a(coordinate(generator), coordinate(generator), coordinate(generator));
+        Vec3f b(coordinate(generator), coordinate(generator), coordinate(generator));
+        float s = coordinate(generator);
+        float d = trial % 2 == 0 ? divisor(generator) : -divisor(generator);
+        Vec3 da(a);
+        Vec3 db(b);
+
+        // one rounding per lane, the double result rounded once is the same
+        bool ok = same(a + b, Vec3f(da + db));
+        ok = ok && same(a - b, Vec3f(da - db));
+        ok = ok && same(a * s, Vec3f(da * s));
+        ok = ok && same(s * a, Vec3f(s * da));
+        ok = ok && same(a / d, Vec3f(da / d));
+        ok = ok && same(-a, Vec3f(-da));
+
+        // rounded after every product and sum, x, y and z added in this order
+        float dot = rounded(rounded(rounded(da.x * db.x) + rounded(da.y * db.y)) + rounded(da.z * db.z));
+        ok = ok && a.dot(b) == dot;
+        Vec3f cross(rounded(rounded(da.y * db.z) - rounded(da.z * db.y)),
+                    rounded(rounded(da.z * db.x) - rounded(da.x * db.z)),
+                    rounded(rounded(da.x * db.y) - rounded(da.y * db.x)));
+        ok = ok && same(a.cross(b), cross);
+
+        Vec3f c = a;
+        Vec3f expected = a;
+        c += b;
+        expected = Vec3f(Vec3(expected) + db);
+        c -= a;
+        expected = Vec3f(Vec3(expected) - da);
+        c *= s;
+        expected = Vec3f(Vec3(expected) * s);
+        c /= d;
+        expected = Vec3f(Vec3(expected) / d);
+        ok = ok && same(c, expected);
+
+        if (!ok)
+            mismatches++;
+    }
+
+    std::cout << mismatches << " of 100000 trials differ from double" << std::endl;
+    CHECK(mismatches == 0);
+    return checkResult();
+}
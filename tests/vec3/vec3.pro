@@ -0,0 +1,4 @@
+TARGET = tst_vec3
+include(../test.pri)
+
+SOURCES += tst_vec3.cpp